@@ -0,0 +1,41 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for running trials until the answer is known precisely enough, rather |
+| than for a fixed number of trials. Worker threads each have a prison of their own, and claim trials in    |
+| batches from a shared counter. After each batch, a worker merges what it saw into the shared summary and  |
+| checks the stopping rule: the 95% Wilson interval of the success rate and the 95% t-interval of the mean  |
+| number of entries must both be narrower than their targets (when given). Checking only between batches    |
+| keeps the shared lock off the hot path, and no worker ever waits for another. Once the rule is met, or the |
+| budget of trials runs out, workers finish the batch they are on and stop.                                 |
+|===========================================================================================================|
+*/
+
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <cstdint>
+#include "stats.h"
+
+class Adaptive;
+
+
+// static class for running trials until a confidence interval is narrow enough
+class Adaptive
+{
+    private:
+        static const inline uint32_t BATCH = 64;    // trials a worker runs between checking the rule
+        static constexpr double Z = 1.959963985;    // standard normal quantile for 95% confidence
+
+        static bool precise_enough(const TrialStats& stats);
+
+    public:
+        static TrialStats run();
+
+        static double success_half_width(const TrialStats& stats);
+        static double wilson_half_width(uint64_t successes, uint64_t trials);
+        static double t_half_width(const Welford& moments);
+};
+
+#endif // ADAPTIVE_H
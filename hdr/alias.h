@@ -0,0 +1,37 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for the weighted warden. It implements Walker's alias method (with    |
+| Vose's construction), which turns a list of weights into a table once, in linear time, after which every |
+| sample takes constant time: pick a column uniformly, then flip a biased coin to decide between the column |
+| itself and its alias. This lets the weighted warden run at the same speed as the uniform one.            |
+|===========================================================================================================|
+*/
+
+#ifndef ALIAS_H
+#define ALIAS_H
+
+#include <random>
+#include <vector>
+
+class AliasTable;
+
+
+// class for sampling indices in proportion to their weights in constant time
+class AliasTable
+{
+    private:
+        std::vector<double> probability;    // chance of keeping each column rather than taking its alias
+        std::vector<uint32_t> alias;        // index to use instead of each column when the coin says so
+        std::uniform_int_distribution<uint32_t> column;     // picks a column uniformly
+        std::uniform_real_distribution<double> coin;        // decides between a column and its alias
+
+    public:
+        AliasTable(const std::vector<double>& weights);
+
+        uint32_t sample(std::mt19937& mt);
+        uint32_t size() const;
+};
+
+#endif // ALIAS_H
@@ -0,0 +1,63 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for carving objects out of a single block of memory. The prison sizes |
+| one arena up front from the number of prisoners, and then creates the prisoners (in index order), the     |
+| switch room, and everything else needed for a challenge inside it, instead of allocating each of them on  |
+| its own. Between trials, the arena is rewound to a mark in constant time rather than freeing every object |
+| one by one. Because of that, objects created in an arena must not own any other memory, or it will leak;  |
+| the few that do must have their destructors called explicitly before rewinding. An arena can also be a    |
+| POSIX shared memory segment, so that processes forked after it was created all see the same objects.      |
+|===========================================================================================================|
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+class Arena;
+
+
+// class for bump allocation out of one contiguous block
+class Arena
+{
+    private:
+        const size_t capacity;  // size of the block in bytes
+        const bool shared;      // whether the block is shared memory, kept by processes forked later
+        char* block;            // the block itself, aligned to a cache line
+        size_t used = 0;        // bytes handed out so far, including padding
+
+        static char* map_shared(size_t bytes);
+
+    public:
+        Arena(size_t bytes, bool shared_memory = false);
+        ~Arena();
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(size_t bytes, size_t alignment);
+        size_t mark() const;
+        void rewind(size_t to);
+        size_t get_used() const;
+        size_t get_capacity() const;
+        bool is_shared() const;
+
+        /**
+         * @brief FACTORY - Constructs an object of type T inside the arena.
+         *
+         * @param args Arguments to forward to the constructor of T.
+         * @return Returns a pointer to the new object, which lives until the arena is rewound past it.
+         * @throws std::bad_alloc When the arena does not have enough room left.
+         */
+        template <typename T, typename... Args>
+        T* create(Args&&... args)
+        {
+            return new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+};
+
+#endif // ARENA_H
@@ -0,0 +1,47 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for the cfs warden. It emulates, in a single thread, the way a fair   |
+| scheduler like Linux's CFS hands out the CPU to prisoner threads that are all runnable at once. Every     |
+| prisoner has a virtual runtime, and the one with the least always runs next, for a time slice that is the |
+| scheduler's target latency split among everyone, but never less than the minimum granularity. During its |
+| slice, a prisoner keeps going back into the room, one visit per visit cost, which is exactly where the    |
+| same-thread-reentry bias of the os warden comes from. Since nothing here depends on real time, a run can  |
+| be reproduced from its seed.                                                                              |
+|===========================================================================================================|
+*/
+
+#ifndef CFS_H
+#define CFS_H
+
+#include <set>
+#include <vector>
+
+class FairScheduler;
+
+
+// class for deciding which prisoner runs next, and for how many visits, like a fair scheduler would
+class FairScheduler
+{
+    private:
+        static constexpr uint64_t TARGET_LATENCY = 6000000;    // ns in which every runnable prisoner runs
+
+        const uint64_t slice;                               // ns a prisoner runs before being preempted
+        const uint64_t visit_cost;                          // ns one visit to the room takes
+        std::vector<uint64_t> vruntime;                     // ns each prisoner has run so far
+        std::set<std::pair<uint64_t, uint32_t>> runnable;   // prisoners by vruntime, leftmost runs next
+        uint64_t clock = 0;                                 // ns of CPU time handed out so far
+        uint64_t slices = 0;                                // number of times a prisoner was picked
+
+    public:
+        FairScheduler(uint32_t number_of_prisoners, uint64_t granularity, uint64_t cost);
+
+        uint32_t pick(uint64_t* visits);
+        void preempt(uint32_t index, uint64_t visits_made);
+        uint64_t get_clock() const;
+        uint64_t get_slice_count() const;
+        uint64_t get_slice() const;
+};
+
+#endif // CFS_H
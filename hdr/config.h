@@ -0,0 +1,126 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains the configuration of one run of the simulator: every parameter that can be given on |
+| the command line, gathered in a plain struct. The program fills one in by parsing the command line (see   |
+| parser.h), while code embedding the simulator fills one in directly and hands it to Simulator::run() (see |
+| simulator.h). The defaults here are the program's defaults, except that a run prints nothing unless asked |
+| to; the command line turns the regular output back on. Values out of range are not checked here, so they  |
+| should stay within the bounds given in the README for the matching option.                                |
+|===========================================================================================================|
+*/
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <cstdint>
+#include <string>
+#include "enums.h"
+
+struct Config;
+
+/**
+ * @brief Whether debug mode is set
+ *
+ * @param d_off Debug mode is off, resulting in normal output.
+ * @param d_on Debug mode is on, resulting in data structure info and extra flow control logging in output.
+ */
+enum debug_mode {
+    d_off   = 0,
+    d_on    = 1
+};
+
+/**
+ * @brief Whether verbose mode is set.
+ *
+ * @param v_off Verbose mode is off, resulting in less output.
+ * @param v_on Verbose mode is on, resulting in more output.
+ */
+enum verb_mode {
+    v_off   = 0,
+    v_on    = 1
+};
+
+/**
+ * @brief How much output should be printed.
+ *
+ * @param normal Print out info about each prisoner who enters and what they do in the room.
+ * @param halfway Only mention prisoners entering, not what they do.
+ * @param silent Print out only the final conclusion.
+ */
+enum out_mode {
+    normal  = 0,
+    halfway = 1,
+    silent  = 2
+};
+
+/**
+ * @brief Format of the results written for every challenge.
+ *
+ * @param f_text Only the regular, human readable output.
+ * @param f_json One JSON object per line for every challenge.
+ * @param f_csv One comma separated row for every challenge, after a header row.
+ */
+enum out_format {
+    f_text  = 0,
+    f_json  = 1,
+    f_csv   = 2
+};
+
+
+// every parameter of one run; the comments name the matching flag or option
+struct Config
+{
+    debug_mode debug = debug_mode::d_off;                   // -d
+    verb_mode verbose = verb_mode::v_off;                   // -v
+    out_mode output = out_mode::silent;                     // -h and -s; the program starts from normal
+    out_format format = out_format::f_text;                 // --format
+    std::string output_path = "";                           // --output, stdout if empty
+    bool counters = false;                                  // -p
+    bool timing = false;                                    // -t
+    uint32_t prisoners = 100;                               // number of prisoners argument
+    switch_state initial_state = switch_state::unknown;     // --initial
+    warden warden_type = warden::os;                        // --warden
+    strategy strategy_type = strategy::proper;              // --strategy
+    bool seed_provided = false;                             // false to have a random seed picked
+    uint32_t seed = 0;                                      // --seed
+    sched_policy policy = sched_policy::p_inherit;          // --policy
+    bool nice_provided = false;                             // whether nice should be applied
+    int32_t nice = 0;                                       // --nice
+    int32_t priority = 1;                                   // --priority
+    bool resetter_policy_provided = false;                  // whether resetter_policy should be applied
+    sched_policy resetter_policy = sched_policy::p_inherit; // --resetter_policy
+    bool resetter_nice_provided = false;                    // whether resetter_nice should be applied
+    int32_t resetter_nice = 0;                              // --resetter_nice
+    bool resetter_priority_provided = false;                // whether resetter_priority should be applied
+    int32_t resetter_priority = 1;                          // --resetter_priority
+    start_mode start = start_mode::s_gate;                  // --start
+    int32_t stagger = 100;                                  // --stagger, in microseconds
+    bool pin = false;                                       // --pin
+    int32_t stack_kib = 128;                                // --stack
+    int32_t rooms = 1;                                      // --rooms
+    handoff_policy handoff = handoff_policy::h_random;      // --handoff
+    int32_t pool = 0;                                       // --pool, 0 for one per CPU
+    int32_t trials = 1;                                     // --trials
+    bool park = false;                                      // --park
+    weight_source weights = weight_source::w_zipf;          // --weights
+    double zipf_exponent = 1.0;                             // --weights=zipf:<s>
+    std::string weights_path = "";                          // --weights=file:<path>
+    arrival_mode arrivals = arrival_mode::a_exp;            // --arrivals
+    double period = 0.0;                                    // --period, 0 for the number of prisoners
+    int32_t granularity = 750000;                           // --granularity, in ns
+    int32_t visit_cost = 1000;                              // --visit_cost, in ns
+    double ci = 0.0;                                        // --ci, 0 when not adaptive
+    double entries_ci = 0.0;                                // --entries_ci, 0 when not adaptive
+    int32_t budget = 1000000;                               // --budget
+    int32_t workers = 0;                                    // --workers, 0 for one per CPU
+    double bias = 0.0;                                      // --bias, 0 when off
+    int32_t progress_ms = 0;                                // --progress, 0 when off
+    std::string progress_path = "";                         // --progress_file, stderr if empty
+    std::string trace_path = "";                            // --trace, off if empty
+    ensemble_mode ensemble = ensemble_mode::e_off;          // --ensemble
+    std::string jobs_path = "";                             // --jobs, one run of these settings if empty
+};
+
+#endif // CONFIG_H
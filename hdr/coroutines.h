@@ -0,0 +1,123 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for the coroutine warden. The os warden gives every prisoner a kernel |
+| thread, which limits it to a few thousand prisoners, while the single threaded wardens don't run the      |
+| prisoners concurrently at all. Here, every prisoner is a C++20 coroutine instead: a loop that waits for   |
+| the room, makes a visit, and backs off, just like a prisoner thread, but that suspends rather than blocks |
+| while the room is occupied. A small pool of threads (one per CPU by default) resumes the coroutines that  |
+| are ready to run. Each thread has a queue of its own, and when it runs dry, it steals the newest prisoner |
+| from another thread's queue. The policies of the handoff warden decide both who a thread resumes next     |
+| from its queue (a random one, or the one who has been ready the longest) and who is handed the room when  |
+| several are waiting for it. A suspended prisoner takes only its coroutine frame and a few words of        |
+| bookkeeping, so millions of them fit where the os warden would need millions of thread stacks.            |
+|===========================================================================================================|
+*/
+
+#ifndef COROUTINES_H
+#define COROUTINES_H
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "enums.h"
+#include "global.h"
+#include "handoff.h"
+#include "prisoner.h"
+#include "switch.h"
+
+class Coroutines;
+
+
+// class for running every prisoner as a coroutine on a pool of threads, for the coro warden
+class Coroutines
+{
+    private:
+        // a prisoner's coroutine, which starts suspended and is only ever destroyed through its handle
+        struct Task
+        {
+            struct promise_type
+            {
+                Task get_return_object();
+                std::suspend_always initial_suspend() noexcept;
+                std::suspend_always final_suspend() noexcept;
+                void return_void();
+                void unhandled_exception();
+            };
+            std::coroutine_handle<promise_type> handle;
+        };
+        using Handle = std::coroutine_handle<Task::promise_type>;
+
+        // awaited by a prisoner to get into the room, suspending them until it is handed over if it is taken
+        struct Entry
+        {
+            Coroutines* pool;                   // pool the prisoner runs in
+            uint32_t index;                     // unique index of the prisoner
+            bool await_ready() const noexcept;
+            bool await_suspend(Handle waiter) const;
+            void await_resume() const noexcept;
+        };
+
+        // awaited by a prisoner to back off after a visit, so that whoever was ready before them goes first
+        struct Backoff
+        {
+            Coroutines* pool;                   // pool the prisoner runs in
+            bool await_ready() const noexcept;
+            void await_suspend(Handle waiter) const;
+            void await_resume() const noexcept;
+        };
+
+        // one thread of the pool; only its own thread changes the counts
+        struct CACHE_ALIGNED Worker
+        {
+            std::mutex m;                       // protects ready
+            std::deque<Handle> ready;           // prisoners ready to be resumed, oldest first
+            std::mt19937 mt;                    // picks who to resume next, for the random policy
+            uint64_t resumes = 0;               // times this thread resumed a prisoner
+            uint64_t steals = 0;                // prisoners this thread took from another's queue
+        };
+
+        static inline thread_local Worker* local = nullptr;            // worker run by the calling thread
+        static inline thread_local std::exception_ptr failure;         // thrown by its last prisoner, if any
+
+        bool* const challenge_finished;         // the challenge's flag, only touched from inside the room
+        const handoff_policy policy;            // who is resumed next, and who gets the room next
+        std::vector<Worker> workers;            // the pool
+        std::vector<Handle> frames;             // every prisoner's coroutine, by unique index, 0 unused
+        std::mutex room_mutex;                  // protects everything down to walk_ins
+        bool occupied = false;                  // whether a prisoner holds the room
+        WaitList waiting;                       // prisoners waiting for the room, and who goes next
+        uint64_t handoffs = 0;                  // times the room went straight to a waiting prisoner
+        uint64_t walk_ins = 0;                  // times a prisoner found the room free
+        std::exception_ptr error;               // first thing a prisoner threw, rethrown by run()
+        std::atomic<bool> over = false;         // set once the challenge is over, or a prisoner threw
+
+        Task visits(Prisoner* p, SwitchRoom* room);
+        bool enter(uint32_t index);
+        void leave(uint32_t index);
+        void schedule(Handle ready);
+        Handle next(uint32_t id);
+        void work(uint32_t id);
+
+    public:
+        Coroutines(const std::vector<Prisoner*>& prisoners, SwitchRoom* room, bool* finished,
+            uint32_t threads, handoff_policy p, uint32_t seed);
+        ~Coroutines();
+        Coroutines(const Coroutines&) = delete;
+        Coroutines& operator=(const Coroutines&) = delete;
+
+        void run();
+        uint32_t get_thread_count() const;
+        uint64_t get_resume_count() const;
+        uint64_t get_steal_count() const;
+        uint64_t get_handoff_count() const;
+        uint64_t get_walk_in_count() const;
+};
+
+#endif // COROUTINES_H
@@ -0,0 +1,51 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for collecting performance counters around the challenge. There are   |
+| two sources: hardware and software events from perf_event_open() (cycles, instructions, cache misses,     |
+| branch misses, context switches, CPU migrations), and resource usage from getrusage() (CPU time, context  |
+| switches, and the peak RSS of the process over its whole life). The perf events are opened with           |
+| inheritance, so they must be started before any prisoner threads are created in order to count them too.  |
+| When perf events are unavailable (for example, in a container or under a strict perf_event_paranoid       |
+| setting), only the getrusage() numbers are reported.                                                      |
+|===========================================================================================================|
+*/
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include <sys/resource.h>
+
+class Counters;
+
+
+// class for collecting hardware and OS performance counters
+class Counters
+{
+    private:
+        static const inline uint8_t NUM_EVENTS = 6;             // number of perf events attempted
+        static inline const char* names[NUM_EVENTS] = {         // names of the perf events, for printing
+            "cycles", "instructions", "cache misses", "branch misses", "context switches", "CPU migrations"
+        };
+        static inline int32_t fds[NUM_EVENTS] = {-1, -1, -1, -1, -1, -1};  // perf event file descriptors
+        static inline uint64_t values[NUM_EVENTS] = {};         // scaled counts, valid after stop()
+        static inline bool read_ok[NUM_EVENTS] = {};            // whether each count was read by stop()
+        static inline bool started = false;                     // prevents stopping before starting
+        static inline rusage usage_start;                       // resource usage when start() was called
+        static inline rusage usage_end;                         // resource usage when stop() was called
+
+        static int32_t open_event(uint32_t type, uint64_t config);
+        static void read_usage(rusage* usage);
+
+    public:
+        static void start();
+        static void stop();
+        static double cpu_seconds();
+        static double process_cpu_seconds();
+        static void print(uint64_t entries);
+};
+
+#endif // COUNTERS_H
@@ -0,0 +1,75 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for running many pseudo warden challenges at once. The state of one   |
+| challenge is tiny: the position of the switch, what the resetter has counted, and for every prisoner how  |
+| many times they have been in and how far they have turned the switch up. So instead of running challenges |
+| one after another in the prison, the ensemble keeps 16 (AVX-512) or 8 (AVX2) of them side by side, one    |
+| per lane of the CPU's vectors, and makes the next visit in every lane with the same few instructions.     |
+| Lanes whose challenge is over are masked off until every lane is done. Each challenge draws its random    |
+| numbers from a stream of its own, seeded from the run's seed and the challenge's number, so a challenge   |
+| comes out exactly the same whichever lane, engine, or worker runs it; the scalar engine, which runs one   |
+| challenge at a time, is the reference the vector engines can be checked against, and is used on CPUs      |
+| without either instruction set. The picks are uniform like the pseudo warden's, but come from             |
+| xoshiro128** rather than the prison's Mersenne Twister, so a given seed gives different challenges than   |
+| it does without the ensemble.                                                                             |
+|===========================================================================================================|
+*/
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <cstdint>
+#include <vector>
+#include "enums.h"
+#include "stats.h"
+
+class Ensemble;
+
+
+// class for running pseudo warden challenges side by side, one in each lane of the CPU's vectors
+class Ensemble
+{
+    private:
+        static const inline uint32_t MAX_LANES = 16;        // lanes of the widest engine
+
+        const ensemble_mode engine;                         // engine in use; never e_off or e_auto
+        const uint32_t lanes;                               // challenges run side by side
+        const uint32_t number_of_prisoners;                 // prisoners in every challenge; the last resets
+        const uint32_t target;                              // steps the resetter counts to
+        const bool improper;                                // whether setters may declare completion too
+        std::vector<uint32_t> words;                        // each prisoner's visits and steps, by lane
+
+        // state of every lane, one entry per lane
+        alignas(64) uint32_t rng[4][MAX_LANES];             // xoshiro128** state
+        alignas(64) uint32_t position[MAX_LANES];           // position of the switch
+        alignas(64) uint32_t counted[MAX_LANES];            // steps the resetter has counted
+        alignas(64) uint32_t flips[MAX_LANES];              // times the switch was turned
+        alignas(64) uint32_t distinct[MAX_LANES];           // prisoners who have been in at least once
+        alignas(64) uint32_t started_off[MAX_LANES];        // all ones once the resetter knows it began off
+        uint64_t entries[MAX_LANES];                        // visits made, once the challenge is over
+        uint64_t coverage[MAX_LANES];                       // visit on which everyone had been in, or 0
+        bool started_on[MAX_LANES];                         // whether the switch started above 0
+
+        uint32_t next(uint32_t lane);
+        void seed(uint32_t lane, uint64_t trial);
+        void finish(uint32_t lane, uint64_t step);
+        void run_scalar(uint32_t used);
+        void run_avx2(uint32_t used);
+        void run_avx512(uint32_t used);
+
+    public:
+        static const inline uint32_t MAX_PRISONERS = 1 << 24;  // keeps every count within 32 bits
+
+        Ensemble(ensemble_mode mode, uint32_t prisoners);
+
+        void run(uint64_t first, uint64_t count, uint32_t worker, TrialStats* stats, ChallengeResult* last);
+        ensemble_mode get_engine() const;
+        uint32_t get_lanes() const;
+
+        static bool supports(ensemble_mode mode);
+        static const char* name(ensemble_mode mode);
+};
+
+#endif // ENSEMBLE_H
@@ -18,13 +18,63 @@ Isaac Jung
  * @param fixed A random permutation is decided in the beginning; the prisoners will follow that order.
  * @param seq Like fixed, but the order is specifically from 1 to 100.
  * @param fast Like sequential, but the resetter will enter any time the switch is in the on position.
+ * @param handoff Threads are used, but the prisoner leaving the room picks who goes in next by a policy.
+ * @param weighted Like pseudo, but each prisoner is picked in proportion to a weight rather than uniformly.
+ * @param event Each prisoner visits on their own random clock in virtual time; a discrete-event simulation.
+ * @param cfs Single threaded emulation of a fair scheduler, so the os warden's biases become reproducible.
+ * @param process Like os, but every prisoner is a process of their own, sharing the room in shared memory.
+ * @param coro Every prisoner is a coroutine, run by a small pool of threads that hands the room around.
  */
 enum warden {
     os      = 0,
     pseudo  = 1,
     fixed   = 2,
     seq     = 3,
-    fast    = 4
+    fast    = 4,
+    handoff = 5,
+    weighted= 6,
+    event   = 7,
+    cfs     = 8,
+    process = 9,
+    coro    = 10
+};
+
+/**
+ * @brief Where the per-prisoner visit weights come from, under the weighted warden.
+ * 
+ * @param w_zipf Weights follow a Zipf law (the k-th most frequent visitor has weight 1/k^s), with the ranks
+ * shuffled among the prisoners by the seed; this is the default.
+ * @param w_file Weights are read from a file, one per prisoner in order of unique index.
+ */
+enum weight_source {
+    w_zipf      = 0,
+    w_file      = 1
+};
+
+/**
+ * @brief Distribution of the time between one prisoner's visits, under the event warden.
+ * 
+ * @param a_exp Exponential, so each prisoner's visits form a Poisson process; this is the default.
+ * @param a_uniform Uniform between 0 and twice the period.
+ * @param a_fixed Exactly one period, with each prisoner's first visit at a random point in the first period.
+ */
+enum arrival_mode {
+    a_exp       = 0,
+    a_uniform   = 1,
+    a_fixed     = 2
+};
+
+/**
+ * @brief How the departing prisoner picks the next one among those waiting, under the handoff or coro warden.
+ * 
+ * @param h_random Any waiting prisoner, uniformly at random; this is the default.
+ * @param h_rr The next waiting prisoner by unique index after the one who was last let in, wrapping around.
+ * @param h_lrv The waiting prisoner who left the room the longest time ago (or never entered).
+ */
+enum handoff_policy {
+    h_random    = 0,
+    h_rr        = 1,
+    h_lrv       = 2
 };
 
 /**
@@ -51,4 +101,53 @@ typedef enum {
     on      = 2
 } switch_state;
 
+/**
+ * @brief Scheduling policy that prisoner threads should run under when the warden is the OS.
+ * 
+ * @param p_inherit Threads keep whatever policy they inherit from the main thread; this is the default.
+ * @param p_other SCHED_OTHER, the normal time-sharing policy (CFS on Linux); can be combined with nice.
+ * @param p_batch SCHED_BATCH, like SCHED_OTHER but the scheduler assumes the threads are CPU-bound.
+ * @param p_idle SCHED_IDLE, for threads that should only run when nothing else wants the CPU.
+ * @param p_fifo SCHED_FIFO, real-time first in, first out; requires a priority and usually privileges.
+ * @param p_rr SCHED_RR, real-time round robin; requires a priority and usually privileges.
+ */
+enum sched_policy {
+    p_inherit   = 0,
+    p_other     = 1,
+    p_batch     = 2,
+    p_idle      = 3,
+    p_fifo      = 4,
+    p_rr        = 5
+};
+
+/**
+ * @brief How prisoner threads are released once they have been created when the warden is the OS.
+ * 
+ * @param s_gate Every thread is created and parked first, then all are released at once; the default.
+ * @param s_stagger Every thread is created and parked first, then they are released one at a time.
+ * @param s_free Each thread starts on its task as soon as it is created, giving early threads a head start.
+ */
+enum start_mode {
+    s_gate      = 0,
+    s_stagger   = 1,
+    s_free      = 2
+};
+
+/**
+ * @brief Which engine runs pseudo warden challenges many at a time, if any.
+ * 
+ * @param e_off Every challenge is run in the prison, one at a time; this is the default.
+ * @param e_auto The widest of the engines below that the CPU supports.
+ * @param e_avx512 16 challenges at a time, one in each lane of AVX-512 vectors.
+ * @param e_avx2 8 challenges at a time, one in each lane of AVX2 vectors.
+ * @param e_scalar 1 challenge at a time, with the same state and random numbers as the vector engines.
+ */
+enum ensemble_mode {
+    e_off       = 0,
+    e_auto      = 1,
+    e_avx512    = 2,
+    e_avx2      = 3,
+    e_scalar    = 4
+};
+
 #endif // ENUMS_H
@@ -0,0 +1,66 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains the classes used for the event warden, which is a discrete-event simulation. Each  |
+| prisoner is brought to the switch room on their own clock, with the time between visits drawn from an    |
+| arrival distribution, and the warden always lets in whoever's next visit comes soonest in virtual time.  |
+| Time is measured in simulated days, so the result answers the question the way the puzzle asks it: how   |
+| long would the prisoners actually be locked up? The pending visits are kept in a 4-ary min-heap with     |
+| exactly one entry per prisoner, so each visit costs one sift down of a shallow heap and nothing more.     |
+|===========================================================================================================|
+*/
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <random>
+#include <vector>
+#include "enums.h"
+
+class ArrivalClock;
+class EventQueue;
+
+
+// class for drawing the time between one prisoner's visits
+class ArrivalClock
+{
+    private:
+        const arrival_mode mode;                            // shape of the distribution
+        const double period;                                // mean days between one prisoner's visits
+        std::exponential_distribution<double> exponential;  // used for exp
+        std::uniform_real_distribution<double> uniform;     // used for uniform, and for the fixed phase
+
+    public:
+        ArrivalClock(arrival_mode m, double mean_period);
+
+        double first(std::mt19937& mt);
+        double next(std::mt19937& mt);
+};
+
+// class for the pending visits, ordered by the virtual time at which they happen
+class EventQueue
+{
+    public:
+        // one pending visit
+        struct Event {
+            double time;        // virtual time of the visit, in days
+            uint32_t index;     // position of the visiting prisoner in the prison's list
+        };
+
+    private:
+        static constexpr size_t ARITY = 4;  // children per node; keeps the heap shallow and siblings adjacent
+
+        std::vector<Event> heap;            // the heap itself, with the soonest event at the front
+
+        void sift_down(size_t at);
+
+    public:
+        EventQueue(std::vector<Event>&& events);
+
+        const Event& top() const;
+        void reschedule_top(double time);
+        size_t size() const;
+};
+
+#endif // EVENTS_H
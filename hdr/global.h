@@ -2,7 +2,11 @@
 Isaac Jung
 
 |===========================================================================================================|
-|   This header contains a class used for holding global variables.                                         |
+|   This header contains a class used for holding global variables. It also defines the CACHE_ALIGNED       |
+| macro, which is placed on data that threads write to often, so that no two threads ever write to the same |
+| cache line (false sharing). Compiling with -DPACKED_LAYOUT (see "make packed") turns the macro into       |
+| nothing, which gives back the old, tightly packed layout for comparison. Compiling with                   |
+| -DSWITCH_POSITIONS=<M> (see "make dial") gives every switch M positions instead of 2.                     |
 |===========================================================================================================|
 */
 
@@ -14,15 +18,34 @@ Isaac Jung
 
 class Global;
 
+#ifndef SWITCH_POSITIONS
+#define SWITCH_POSITIONS 2
+#elif SWITCH_POSITIONS < 2 || SWITCH_POSITIONS > 255
+#error "SWITCH_POSITIONS must be from 2 to 255"
+#endif
+
+#ifdef PACKED_LAYOUT
+#define CACHE_ALIGNED
+#else
+#define CACHE_ALIGNED alignas(Global::CACHE_LINE)
+#endif
+
 
 // class for holding global variables and constants.
 class Global
 {
     public:
-        static std::mutex output_mutex;                     // used for threaded console printing
-        static inline int32_t PID = getpid();               // main thread's process ID
-        const static inline uint8_t SETTER_MAX_COUNT = 2;   // count that setters want to set the switch
-        const static inline float WAIT_TIME = 0.2;          // for avoiding repeated thread preemption
+        static std::mutex output_mutex;                             // used for threaded console printing
+        static inline int32_t PID = getpid();                       // main thread's process ID
+        const static inline uint8_t POSITIONS = SWITCH_POSITIONS;   // positions of every switch, see switch.h
+        const static inline uint8_t SETTER_MAX_COUNT = POSITIONS;   // steps setters turn the switch up
+        const static inline float WAIT_TIME = 0.2;                  // for avoiding repeated thread preemption
+        const static inline size_t CACHE_LINE = 64;                 // bytes per cache line, for CACHE_ALIGNED
+#ifdef PACKED_LAYOUT
+        const static inline bool PACKED = true;                     // whether CACHE_ALIGNED is turned off
+#else
+        const static inline bool PACKED = false;                    // whether CACHE_ALIGNED is turned off
+#endif
 };
 
 #endif // GLOBAL_H
@@ -0,0 +1,81 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for the directed handoff warden. Prisoners still run in their own     |
+| threads, but instead of all fighting over the switch room's mutex, a prisoner who finds the room occupied |
+| parks on its own condition variable. When the occupant locks the room behind them, they pick exactly one  |
+| of the parked prisoners according to a policy and wake only that one, handing the room over directly. If  |
+| no one is waiting, the room is simply left free, and the next prisoner to arrive walks right in. This     |
+| keeps real threads and real context switches, but the admission order is controlled by the policy rather  |
+| than by whichever thread happens to win the mutex, and there is no thundering herd on each handoff.       |
+| Picking by the policy is done by a WaitList of its own, which the coroutine warden uses too.              |
+|===========================================================================================================|
+*/
+
+#ifndef HANDOFF_H
+#define HANDOFF_H
+
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+#include "enums.h"
+#include "global.h"
+
+class WaitList;
+class Handoff;
+
+
+// class for the prisoners waiting for a room, which picks who goes next by a policy; not thread safe
+class WaitList
+{
+    private:
+        const handoff_policy policy;                        // how the next prisoner is chosen
+        std::vector<uint64_t> last_visit;                   // clock value when each prisoner last left
+        uint64_t clock = 0;                                 // incremented every time someone leaves
+        uint32_t last_granted = 0;                          // index of the last prisoner let in
+        std::mt19937 mt;                                    // picks the next prisoner for the random policy
+        std::vector<uint32_t> waiting;                      // waiting prisoners, for the random policy
+        std::set<uint32_t> waiting_rr;                      // waiting prisoners, for the rr policy
+        std::set<std::pair<uint64_t, uint32_t>> waiting_lrv;// waiting prisoners by last visit, for lrv
+
+    public:
+        WaitList(uint32_t number_of_prisoners, handoff_policy p, uint32_t seed);
+
+        void push(uint32_t index);
+        uint32_t pop();
+        bool empty() const;
+        void grant(uint32_t index);
+        void leave(uint32_t index);
+};
+
+
+// class for handing the switch room directly from one prisoner thread to the next
+class Handoff
+{
+    private:
+        // state kept for each prisoner, indexed by their unique index
+        struct CACHE_ALIGNED Slot {
+            std::condition_variable cv;     // the prisoner parks on this while waiting for the room
+            bool granted = false;           // set by the departing prisoner when the room is handed over
+        };
+
+        std::mutex m;                                       // protects everything below
+        std::vector<Slot> slots;                            // one per prisoner, index 0 unused
+        WaitList waiting;                                   // parked prisoners, and who goes next
+        bool occupied = false;                              // whether someone currently holds the room
+        uint64_t handoffs = 0;                              // times the room went straight to a waiter
+        uint64_t walk_ins = 0;                              // times someone found the room free
+
+    public:
+        Handoff(uint32_t number_of_prisoners, handoff_policy p, uint32_t seed);
+
+        void acquire(uint32_t index);
+        void release(uint32_t index);
+        uint64_t get_handoff_count();
+        uint64_t get_walk_in_count();
+};
+
+#endif // HANDOFF_H
@@ -0,0 +1,41 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for estimating how likely the improper strategy is to fail under the  |
+| pseudo warden, when failures are far too rare to count directly. Instead of picking every prisoner with  |
+| the same probability, prisoners who have already been in the room are picked b times as often as those  |
+| who haven't, which keeps someone left out for longer and so makes early, wrong claims more likely. Each   |
+| pick is then weighed by how much more likely it was under the real warden than under the biased one, so  |
+| that the average of the weight times the failure indicator is still exactly the real failure probability.|
+|===========================================================================================================|
+*/
+
+#ifndef IMPORTANCE_H
+#define IMPORTANCE_H
+
+#include <random>
+#include <vector>
+
+class BiasedPicker;
+
+
+// class for picking prisoners with a bias toward those already visited, while tracking the likelihood ratio
+class BiasedPicker
+{
+    private:
+        const uint32_t n;                   // number of prisoners
+        const double bias;                  // how many times as likely a visited prisoner is to be picked
+        std::vector<uint32_t> order;        // positions of the prisoners, visited ones first
+        uint32_t visited = 0;               // number of prisoners at the front of order who have been in
+        double log_weight = 0.0;            // log of the likelihood ratio of every pick so far
+        std::uniform_real_distribution<double> unit;    // decides between visited and unvisited
+
+    public:
+        BiasedPicker(uint32_t number_of_prisoners, double b);
+
+        uint32_t pick(std::mt19937& mt);
+        double get_weight() const;
+};
+
+#endif // IMPORTANCE_H
@@ -0,0 +1,51 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for running a batch of scenarios in one process, instead of starting  |
+| the program once for each. A jobs file has one scenario per line, written the same way as the command     |
+| line: usually the number of prisoners, followed by options such as the warden, strategy, initial state,   |
+| seed, and number of trials. Whatever a line leaves out is taken from the command line, and blank lines    |
+| and lines starting with # are skipped. Every line is parsed before any job runs, so a mistake shows up    |
+| right away, and then a pool of workers claims jobs one at a time and runs each of them with               |
+| Simulator::run(). Jobs finish in whatever order they happen to, but the line describing each one is only  |
+| written once every job above it has been, so the output always follows the file. A job whose warden runs  |
+| the prisoners on threads or processes of their own already keeps every CPU busy, so it only runs once no  |
+| other job is running, while the rest share the workers.                                                   |
+|===========================================================================================================|
+*/
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "simulator.h"
+
+class Jobs;
+
+
+// static class for running every line of a jobs file as a run of its own
+class Jobs
+{
+    private:
+        static const inline size_t BUFFER_SIZE = 1 << 20;  // bytes collected before each write to the OS
+
+        // one line of the jobs file
+        struct Job {
+            uint64_t line;                                  // line number in the file, counting from 1
+            Config config;                                  // settled configuration of the job's run
+        };
+
+        static std::vector<Job> load(const Config& base, const std::string& path, bool notes);
+        static void describe(std::string* out, out_format format, const Job& job, const Results& results);
+        static uint32_t line_seed(uint32_t seed, uint64_t line);
+        static bool is_threaded(warden w);
+
+    public:
+        static bool run(const Config& config);
+};
+
+#endif // JOBS_H
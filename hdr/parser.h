@@ -4,11 +4,14 @@ Isaac Jung
 |===========================================================================================================|
 |   This header contains a class used for processing input. Should the input format change, this class can  |
 | be updated accordingly. The way this class is used is to have the main code call the public parse()       |
-| method. This will parse command line arguments separated by whitespace. The parse() method must be called |
-| before the getter methods can be called. Other modules can also include this header and call the getters  |
-| to inspect the program state based on the user-given arguments, but again, the parse() method must first  |
-| be called, exactly once in the beginning of the program. Another thing this header file contains is a     |
-| series of enums for very general program needs.                                                        |
+| method. This will parse command line arguments separated by whitespace into a Config (see config.h), and  |
+| put that configuration in effect. The getter methods read whichever configuration is in effect on the     |
+| calling thread, so they can only be called after that. Other modules can include this header and call the |
+| getters to inspect the configuration. Simulator::run() puts the configuration it was given in effect for  |
+| the length of a run, and every thread the simulator starts adopts the configuration of the thread that    |
+| started it, so that runs on different threads never see each other's settings. The lines of a jobs file   |
+| are parsed by parse_line(), the same way as the command line, but into a Config of their own, which is    |
+| neither checked nor put in effect.                                                                        |
 |===========================================================================================================|
 */
 
@@ -16,77 +19,86 @@ Isaac Jung
 #define PARSER_H
 
 #include <string>
+#include <vector>
+#include "config.h"
 #include "enums.h"
 
 class Parser;
 
-/**
- * @brief Whether debug mode is set
- * 
- * @param d_off Debug mode is off, resulting in normal output.
- * @param d_on Debug mode is on, resulting in data structure info and extra flow control logging in output.
- */
-enum debug_mode {
-    d_off   = 0,
-    d_on    = 1
-};
-
-/**
- * @brief Whether verbose mode is set.
- * 
- * @param v_off Verbose mode is off, resulting in less output.
- * @param v_on Verbose mode is on, resulting in more output.
- */
-enum verb_mode {
-    v_off   = 0,
-    v_on    = 1
-};
-
-/**
- * @brief How much output should be printed.
- * 
- * @param normal Print out info about each prisoner who enters and what they do in the room.
- * @param halfway Only mention prisoners entering, not what they do.
- * @param silent Print out only the final conclusion.
- */
-enum out_mode {
-    normal  = 0,
-    halfway = 1,
-    silent  = 2
-};
-
 
 // parses command line input
 class Parser
 {
     private:
-        static inline bool parse_called = false;            // prevents calling other methods before parse()
-        static inline debug_mode d = debug_mode::d_off;         // debug mode, d_off by default
-        static inline verb_mode v = verb_mode::v_off;           // verbose mode, v_off by default
-        static inline out_mode o = out_mode::normal;            // output mode, normal by default
-        static inline uint32_t num_p = 100;                     // number of prisoners, 100 by default
-        static inline switch_state i_s = switch_state::unknown; // initial switch state, unknown by default
-        static inline warden w = warden::os;                    // warden type, os by default
-        static inline strategy strat = strategy::proper;        // strategy to use, "proper" by default
-        static inline bool seed_provided = false;               // whether seed was given, false until found
-        static inline uint32_t seed = 0;                        // user-given seed, empty string by default
+        static inline thread_local const Config* active = nullptr; // configuration in effect on this thread
+        static inline Config parsed;                                // what parse() found on the command line
+        static inline Config given;                                 // the same, before check() settled it
+        static inline bool seed_from_user = false;                  // whether the command line gave a seed
 
-        static void handle_option(const std::string& arg);
-        static void handle_flags(const std::string& arg);
-        static void handle_argument(const std::string& arg);
+        static void handle_arguments(const std::vector<std::string>& args, Config* c);
+        static void handle_option(const std::string& arg, Config* config);
+        static void handle_flags(const std::string& arg, Config* target);
+        static void handle_argument(const std::string& arg, Config* c, uint32_t* numbers);
+        static bool handle_policy(const std::string& value, sched_policy* target);
+        static bool handle_int(const std::string& value, int32_t min, int32_t max, int32_t* target);
+        static bool handle_double(const std::string& value, double min, double max, double* target);
 
     public:
         static void parse(int32_t argc, char *argv[]);
+        static Config parse_line(const std::string& line, const Config& base);
+        static void check(Config& config, bool notes);
+        static const Config* adopt(const Config* config);
+        static const Config& get_config();
+        static const Config& get_given_config();
 
         static bool debug_is_on();
         static bool verbose_is_on();
         static out_mode get_output_mode();
+        static out_format get_format();
+        static std::string get_output_path();
+        static bool records_own_stdout();
+        static bool counters_are_on();
+        static bool timing_is_on();
         static uint32_t get_number_of_prisoners();
         static switch_state get_initial_switch_state();
         static warden get_warden();
         static strategy get_strategy();
         static bool seed_is_from_user();
         static uint32_t get_seed();
+        static sched_policy get_sched_policy(bool resetter = false);
+        static bool nice_is_set(bool resetter = false);
+        static int32_t get_nice(bool resetter = false);
+        static int32_t get_sched_priority(bool resetter = false);
+        static start_mode get_start_mode();
+        static int32_t get_stagger();
+        static bool pin_is_on();
+        static size_t get_stack_size();
+        static uint32_t get_rooms();
+        static handoff_policy get_handoff_policy();
+        static uint32_t get_pool_size();
+        static uint32_t get_trials();
+        static bool park_is_on();
+        static weight_source get_weight_source();
+        static double get_zipf_exponent();
+        static std::string get_weights_path();
+        static arrival_mode get_arrival_mode();
+        static double get_period();
+        static uint64_t get_granularity();
+        static uint64_t get_visit_cost();
+        static bool adaptive_is_on();
+        static double get_ci();
+        static double get_entries_ci();
+        static uint32_t get_budget();
+        static uint32_t get_workers();
+        static bool importance_is_on();
+        static double get_bias();
+        static bool progress_is_on();
+        static uint32_t get_progress_interval();
+        static std::string get_progress_path();
+        static std::string get_trace_path();
+        static std::string get_jobs_path();
+        static ensemble_mode get_ensemble_mode();
+        static bool ensemble_is_on();
 };
 
 #endif // PARSER_H
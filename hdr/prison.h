@@ -7,8 +7,12 @@ Isaac Jung
 | so there is no unique class for the warden, only an enum (found in enums.h). However, the prison does     |
 | consist of a bunch of prisoners, as well as the switch room. The class is static, as there should not be  |
 | more than one instance of the prison. The main program should first initialize teverything with init(),   |
-| and then it may call the challenge() method to begin the main loop. The free_memory() method should be    |
-| called after challenge() for a clean exit.                                                                |
+| and then it may call the challenge() method to begin the main loop. To run another trial, call reset()    |
+| and then challenge() again. The free_memory() method should be called after the last challenge() for a    |
+| clean exit. All of the prison's state is per thread, so parallel workers can each run their own trials.  |
+| There is normally one switch room; with "--rooms", there are several, and each prisoner only ever visits  |
+| their own (see rooms.h). Under the process warden, the arena is shared memory, so prisoner processes      |
+| forked from the program work on the very same objects (see processes.h).                                  |
 |===========================================================================================================|
 */
 
@@ -17,7 +21,13 @@ Isaac Jung
 
 #include <random>
 #include <vector>
+#include "alias.h"
+#include "arena.h"
+#include "handoff.h"
 #include "prisoner.h"
+#include "processes.h"
+#include "rooms.h"
+#include "stats.h"
 #include "switch.h"
 
 class Prison;
@@ -27,23 +37,39 @@ class Prison;
 class Prison
 {
     private:
-        static inline bool init_called = false;             // prevents calling other methods before init()
-        static inline uint32_t total_number_of_prisoners;   // number of prisoners in the prison
-        static inline uint8_t prisoner_unique_index_len;    // char buffer size needed for prisoner ids
-        static inline std::vector<Prisoner*> prisoners;     // actual prisoners in the prison
-        static inline SwitchRoom* switch_room = nullptr;    // room containing the switch
-        static inline std::mt19937* mt = nullptr;           // Mersenne Twister for pseudorandom behavior
+        // every worker running trials in parallel has a prison of its own
+        static inline thread_local bool init_called = false;            // no other calls before init()
+        static inline thread_local uint32_t total_number_of_prisoners;  // number of prisoners in the prison
+        static inline thread_local uint8_t prisoner_unique_index_len;   // char buffer size for prisoner ids
+        static inline thread_local Arena* arena = nullptr;              // memory every object below lives in
+        static inline thread_local size_t arena_mark = 0;               // arena position after the Twister
+        static inline thread_local std::vector<Prisoner*> prisoners;    // actual prisoners in the prison
+        static inline thread_local std::vector<SwitchRoom*> rooms;     // rooms containing the switches
+        static inline thread_local std::mt19937* mt = nullptr;          // Twister for pseudorandomness
+        static inline thread_local Handoff* handoff_control = nullptr;  // picks who's next, handoff warden
+        static inline thread_local Processes* process_control = nullptr;   // gate and end, process warden
+        static inline thread_local AliasTable* alias = nullptr;         // picks who's next, weighted warden
+        static inline thread_local ChallengeResult result;              // what the last challenge came to
+
+        static const inline double MIN_SHARE = 1e-7;    // least chance a weighted prisoner may be picked with
 
         static uint8_t calculate_prisoner_unique_index_len(uint32_t number_of_prisoners);
+        static std::vector<double> load_weights(uint32_t number_of_prisoners);
+        static void populate();
+        static void clear();
+        static void visit(uint32_t idx, bool* challenge_finished);
     
     public:
-        static void init();
+        static void init(uint32_t stream = 0);
+        static void reset();
         static void free_memory();
 
         static uint32_t num_prisoners();
         static uint8_t prisoner_id_len();
+        static bool is_threaded();
 
         static bool challenge();
+        static const ChallengeResult& last_result();
 };
 
 #endif // PRISON_H
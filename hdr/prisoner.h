@@ -8,13 +8,15 @@ Isaac Jung
 | switch to its "reset" state (in this case, the off state). Therefore, the design of this header file has  |
 | a parent class and two child classes: the parent class is the abstract Prisoner class, which contains a   |
 | lot of the data and method members shared in common between the two roles, while the Setter and Restter   |
-| are child classes which inherit from Prisoner.                                                            |
+| are child classes which inherit from Prisoner. When there is more than one switch room, a third role, the |
+| relay, counts one of the other rooms; it is found in rooms.h.                                             |
 |===========================================================================================================|
 */
 
 #ifndef PRISONER_H
 #define PRISONER_H
 
+#include <string>
 #include "global.h"
 #include "switch.h"
 
@@ -23,28 +25,35 @@ class Setter;
 class Resetter;
 
 
-// base class for the two prisoner roles, setter and resetter
-class Prisoner
+// base class for the two prisoner roles, setter and resetter; aligned so no two share a cache line
+class CACHE_ALIGNED Prisoner
 {
     protected:
-        const uint32_t unique_index;    // identity, for keeping track of who's who
-        const std::string str_rep;      // memoized to_string_internal
         bool in_switch_room = false;    // true while this prisoner is in the switch room
+        uint8_t name_len = 0;           // length of the "Prisoner #x" part of str_rep
         uint32_t flip_count = 0;        // how many times this prisoner has flipped the switch
         uint64_t entered_count = 0;     // how many times this prisoner has actually entered
+        const uint32_t unique_index;    // identity, for keeping track of who's who
+        const uint32_t room;            // the only switch room this prisoner visits, 0 unless --rooms
+        char str_rep[32];               // memoized to_string_internal, inline to need no heap memory
 
-        std::string to_string_internal(uint32_t index) const;
+        void to_string_internal(uint32_t index, const char* role);
 
         void declare_completion(bool* challenge_finished);
 
     public:
-        Prisoner(uint32_t index);
+        Prisoner(uint32_t index, uint32_t room_number = 0);
         virtual ~Prisoner() {};
         
         virtual std::string to_string() const = 0;
+        virtual bool is_resetter() const = 0;
+        uint32_t get_index() const;
+        uint32_t get_room() const;
         bool is_in_switch_room();
         void set_in_switch_room(bool in_room);
         bool has_been_in_switch_room();
+        uint64_t get_entered_count() const;
+        uint32_t get_flip_count() const;
 
         virtual void perform_task(bool* challenge_finished, SwitchRoom* switch_room) = 0;
 };
@@ -55,15 +64,13 @@ class Setter : public Prisoner
 {
     private:
         static const uint8_t target_count = Global::SETTER_MAX_COUNT;   // count setter wants to set
-        const std::string str_rep;                              // memoized to_string_internal
-
-        std::string to_string_internal(uint32_t index) const;
 
     public:
-        Setter(uint32_t index);
+        Setter(uint32_t index, uint32_t room_number = 0);
         ~Setter();
 
         std::string to_string() const;
+        bool is_resetter() const;
 
         void perform_task(bool* challenge_finished, SwitchRoom* switch_room);
 };
@@ -75,16 +82,21 @@ class Resetter : public Prisoner
     private:
         switch_state switch_start_state = unknown;  // can be updated to off in a specific case
         const uint64_t target_count;                // count resetter wants to reset
-        const std::string str_rep;                  // memoized to_string_internal
 
-        std::string to_string_internal(uint32_t index) const;
-        uint64_t calculate_target_count() const;
+        static uint64_t calculate_target_count(uint32_t counted);
+
+    protected:
+        bool done_counting = false;                 // set once target_count is reached
+
+        virtual void finish_counting(bool* challenge_finished);
 
     public:
-        Resetter(uint32_t index);
+        Resetter(uint32_t index, uint32_t room_number, uint32_t counted);
         ~Resetter();
 
         std::string to_string() const;
+        bool is_resetter() const;
+        uint64_t get_target_count() const;
 
         void perform_task(bool* challenge_finished, SwitchRoom* switch_room);
 };
@@ -0,0 +1,87 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains the classes used for the process warden. Every prisoner is a process of its own,   |
+| forked from the program, instead of a thread, so they contend for the switch room the way independent     |
+| programs contend for a shared resource. For that, the prison's whole arena is a POSIX shared memory       |
+| segment (see arena.h), mapped at the same address in every process, so the prisoners, the switch rooms,   |
+| and their counters are the very same objects the threaded wardens use. What a thread library can't share  |
+| between processes is replaced: each room is locked with a ProcessKey, a process shared mutex that is also |
+| robust, so that a prisoner process dying inside the room can't lock everyone else out forever, and the    |
+| start gate and the end of the challenge go through a Processes object, which also lives in the segment.   |
+| The Processes class also forks the prisoners and reaps them, reporting any that died before the challenge |
+| was over.                                                                                                 |
+|===========================================================================================================|
+*/
+
+#ifndef PROCESSES_H
+#define PROCESSES_H
+
+#include <cstdint>
+#include <functional>
+#include <pthread.h>
+#include <string>
+#include <sys/types.h>
+#include <time.h>
+#include <vector>
+#include "timing.h"
+
+class ProcessKey;
+class Processes;
+
+
+// class for the lock on a switch room under the process warden; robust, and shared between processes
+class ProcessKey
+{
+    private:
+        pthread_mutex_t mutex;          // the lock itself, which must stay in shared memory
+        uint32_t recovered_count = 0;   // times a prisoner got the lock after its holder died
+
+    public:
+        ProcessKey();
+        ~ProcessKey();
+        ProcessKey(const ProcessKey&) = delete;
+        ProcessKey& operator=(const ProcessKey&) = delete;
+
+        void lock();
+        void unlock();
+        uint32_t get_recovered_count() const;
+};
+
+
+// class for the start gate and the end of a challenge under the process warden, shared between processes
+class Processes
+{
+    private:
+        pthread_mutex_t mutex;          // protects everything below; robust, like a ProcessKey
+        pthread_cond_t cv;              // signals arrivals, releases, and the end of the challenge
+        uint32_t arrived = 0;           // number of prisoner processes waiting at the start gate
+        uint32_t released = 0;          // tickets below this may pass the start gate
+        bool over = false;              // set once the challenge is declared over, or called off
+
+        static const inline uint32_t LOOK_IN_MS = 50;   // how often reap() checks on the prisoners
+
+        void acquire();
+        void wait(const timespec* until = nullptr);
+
+    public:
+        bool finished = false;          // handed to every prisoner as the challenge_finished flag
+        Timing::Clocks clocks;          // where the prisoners mark their start and the first entry
+
+        Processes();
+        ~Processes();
+        Processes(const Processes&) = delete;
+        Processes& operator=(const Processes&) = delete;
+
+        void gate_wait(uint32_t ticket);
+        void gate_await(uint32_t count);
+        void gate_release(uint32_t count, int32_t stagger);
+        void finish();
+        bool await_finish(uint32_t ms);
+
+        static pid_t spawn(const std::function<void()>& task);
+        static std::string reap(const std::vector<pid_t>& pids, Processes* control);
+};
+
+#endif // PROCESSES_H
@@ -0,0 +1,74 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for watching a long challenge while it runs. Whoever holds the switch |
+| room publishes the room's counters into a snapshot on their way out, guarded by a sequence lock: the      |
+| sequence number is odd while the snapshot is being written, so a reader who sees the same even number    |
+| before and after reading knows they got a consistent copy. A sampler thread wakes up at a fixed interval, |
+| reads the snapshot, and writes a one line status. It never takes the room's key and never makes the room  |
+| wait on it, so watching a run changes its schedule as little as possible. The class is static.            |
+|===========================================================================================================|
+*/
+
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include "prisoner.h"
+
+class Progress;
+
+
+// static class for the progress snapshot and the sampler thread that reports on it
+class Progress
+{
+    private:
+        // a consistent copy of the snapshot, as read by the sampler
+        struct Snapshot
+        {
+            uint64_t challenge;     // number of challenges begun, so the one being watched counting from 1
+            uint64_t entries;       // room entries so far
+            uint32_t flips;         // switch flips so far
+            uint64_t resets;        // times the resetter has turned the switch off
+            uint64_t reset_target;  // times the resetter means to turn it off
+            uint32_t visitors;      // prisoners who have been in at least once
+            uint32_t population;    // prisoners who could be
+        };
+
+        // the snapshot itself; only written by the room's occupant (or before the challenge starts)
+        static inline std::atomic<uint64_t> sequence{0};    // odd while the snapshot is being written
+        static inline std::atomic<uint64_t> challenge{0};
+        static inline std::atomic<uint64_t> entries{0};
+        static inline std::atomic<uint32_t> flips{0};
+        static inline std::atomic<uint64_t> resets{0};
+        static inline std::atomic<uint64_t> reset_target{0};
+        static inline std::atomic<uint32_t> visitors{0};
+        static inline std::atomic<uint32_t> population{0};
+
+        // the sampler
+        static inline std::thread sampler;                  // thread writing the status lines
+        static inline std::mutex m;                         // protects stopping
+        static inline std::condition_variable wake;         // cuts the sampler's wait short when stopping
+        static inline bool stopping = false;                // tells the sampler to finish
+        static inline std::ofstream file;                   // where status lines go, unless it's stderr
+
+        static void write_begin();
+        static void write_end();
+        static Snapshot read();
+        static void sample(uint32_t interval_ms);
+
+    public:
+        static void start();
+        static void begin(uint32_t number_of_prisoners, uint64_t target);
+        static void publish(uint64_t entered, uint32_t flipped, uint32_t distinct, const Prisoner* occupant);
+        static void stop();
+};
+
+#endif // PROGRESS_H
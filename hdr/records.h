@@ -0,0 +1,46 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for writing one machine readable record per challenge, as JSON lines  |
+| or CSV, for other programs to consume instead of parsing the regular output. Records are formatted into   |
+| a large in-memory buffer, which is only handed to the OS when it fills up or the records are closed, so   |
+| even millions of short challenges cost few system calls. The class is static, and safe to write to from  |
+| parallel workers.                                                                                         |
+|===========================================================================================================|
+*/
+
+#ifndef RECORDS_H
+#define RECORDS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include "enums.h"
+#include "parser.h"
+#include "stats.h"
+
+class Records;
+
+
+// static class for writing one record per challenge
+class Records
+{
+    private:
+        static const inline size_t BUFFER_SIZE = 1 << 20;  // bytes collected before each write to the OS
+
+        static inline std::mutex m;                         // protects everything below
+        static inline std::FILE* file = nullptr;            // where records go; stdout or the output file
+        static inline std::string buffer;                   // records not yet handed to the OS
+
+        static void flush();
+
+    public:
+        static const char* warden_name(warden w);
+        static void open();
+        static void write(const ChallengeResult& result, uint64_t trial, uint32_t worker);
+        static void close();
+};
+
+#endif // RECORDS_H
@@ -0,0 +1,62 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains the pieces of the multi-room variant, where the prison has several switch rooms,   |
+| each with its own lock and its own switch, so that prisoner threads visiting different rooms never wait   |
+| on each other. Every prisoner belongs to exactly one room, and only ever visits that one. Room 0 is the   |
+| chief's room, where the resetter counts as usual. Every other room has a relay instead: a prisoner who    |
+| counts the setters of their own room exactly like the resetter would, and who then carries that count to  |
+| the chief's room by turning the chief's switch up exactly like a setter would (on twice, for the usual    |
+| switch). The chief therefore counts their own room's setters plus one relay per other room, and can only  |
+| reach their target once every room has been fully counted, which keeps the strategy guaranteed to         |
+| succeed. With a single room, this is the original problem. The Rooms class divides the prisoners among    |
+| the rooms, and the Relay class is the relay's role.                                                       |
+|===========================================================================================================|
+*/
+
+#ifndef ROOMS_H
+#define ROOMS_H
+
+#include <cstdint>
+#include "global.h"
+#include "prisoner.h"
+#include "switch.h"
+
+class Rooms;
+class Relay;
+
+
+// static class for dividing the prisoners among the switch rooms
+class Rooms
+{
+    public:
+        static uint32_t room_of(uint32_t index, uint32_t number_of_prisoners, uint32_t number_of_rooms);
+        static uint32_t size_of(uint32_t room, uint32_t number_of_prisoners, uint32_t number_of_rooms);
+        static bool is_relay(uint32_t index, uint32_t number_of_prisoners, uint32_t number_of_rooms);
+};
+
+
+// child class of resetter which counts their own room, and then carries the count to the chief's room
+class Relay : public Resetter
+{
+    private:
+        static const uint8_t carry_target = Global::SETTER_MAX_COUNT;  // times to turn the chief's switch on
+        SwitchRoom* chief_room = nullptr;   // where the count is carried once their own room is counted
+        uint8_t carried = 0;                // times they have turned the chief's switch on
+
+        void carry(bool* challenge_finished);
+
+    protected:
+        void finish_counting(bool* challenge_finished);
+
+    public:
+        Relay(uint32_t index, uint32_t room_number, uint32_t counted);
+        ~Relay();
+
+        void set_chief_room(SwitchRoom* room);
+
+        void perform_task(bool* challenge_finished, SwitchRoom* switch_room);
+};
+
+#endif // ROOMS_H
@@ -0,0 +1,71 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains the entry point for code that embeds the simulator instead of running the program. |
+| Fill in a Config (see config.h), hand it to Simulator::run(), and read the Results it returns. A run puts |
+| its configuration and its clocks in effect on the calling thread, hands both to every thread it starts,   |
+| and puts back whatever was in effect before once it returns, so any number of runs may go on at once on   |
+| different threads, each with its own settings and its own seed. The exceptions are the outputs shared by  |
+| the whole process: records, progress lines, traces, and performance counters. A run that turns any of     |
+| them on must be the only one going on, so Simulator::run() throws instead of starting it beside another   |
+| run, or starting another run beside it. The makefile builds everything but the program's own entry point  |
+| into libprisoners.a (see "make library"), which can be linked into other programs along with -lpthread.   |
+|===========================================================================================================|
+*/
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <cstdint>
+#include <mutex>
+#include "config.h"
+#include "stats.h"
+#include "timing.h"
+
+class Simulator;
+
+// what one run of the simulator came to
+struct Results {
+    bool success = false;               // whether the prisoners went free in every trial
+    uint64_t trials = 0;                // number of challenges run
+    uint64_t successes = 0;             // number of challenges in which the claim was correct
+    uint32_t seed = 0;                  // seed the run used, picked at random if the config had none
+    ChallengeResult last;               // what the last challenge came to, unless run adaptively
+    TrialStats stats;                   // summary of every challenge
+    double phase_seconds[phase::ph_teardown + 1] = {};  // seconds spent in each phase, summed over trials
+};
+
+
+// static class for running the simulator from other code
+class Simulator
+{
+    private:
+        // puts a run's configuration and clocks in effect on the calling thread, and back however it ends
+        class Scope
+        {
+            private:
+                const Config* outer_config;     // in effect before the run
+                Timing::Clocks* outer_clocks;   // in effect before the run
+                Timing::Clocks* run_clocks;     // the run's own, added to the outer ones at the end
+                bool exclusive;                 // whether the run uses outputs of the whole process
+
+            public:
+                Scope(const Config* config, Timing::Clocks* clocks);
+                ~Scope();
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+        };
+
+        static inline std::mutex runs_mutex;            // protects the two below
+        static inline uint32_t runs = 0;                // number of runs going on in the process
+        static inline bool exclusive_run = false;       // whether one of them uses outputs of the process
+
+        static bool is_exclusive(const Config& config);
+        static void run_trials(Results* results);
+
+    public:
+        static Results run(const Config& config);
+};
+
+#endif // SIMULATOR_H
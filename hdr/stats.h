@@ -0,0 +1,136 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains the classes used to summarize many challenges without remembering each one. Every |
+| metric keeps an exact count, mean, variance, minimum and maximum with Welford's method, plus a quantile  |
+| sketch in the style of DDSketch: values are counted in buckets whose bounds grow geometrically, so any   |
+| quantile read back is within a fixed relative error of the true one, and the number of buckets is capped |
+| no matter how many values go in. Both parts can be merged, so workers can each keep their own and      |
+| combine them at the end. TrialStats puts one of these behind every metric a challenge reports.            |
+|===========================================================================================================|
+*/
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+class Welford;
+class QuantileSketch;
+class Statistic;
+class TrialStats;
+
+// what one challenge came to, as reported by the prison
+struct ChallengeResult {
+    bool success = false;       // whether the claim was correct
+    uint64_t entries = 0;       // total number of times the room was entered
+    uint32_t flips = 0;         // total number of times the switch was flipped
+    double seconds = 0.0;       // wall time of the challenge
+    double cpu_seconds = 0.0;   // CPU time the whole process used during the challenge
+    uint64_t coverage = 0;      // entry on which everyone had been in at least once, 0 if never
+    double weight = 1.0;        // likelihood ratio of the path taken, 1 unless importance sampling
+    bool started_on = false;    // whether the switch started in the on position
+};
+
+
+// class for the exact count, mean, variance and extremes of a stream of values
+class Welford
+{
+    private:
+        uint64_t count = 0;     // number of values so far
+        double mean = 0.0;      // running mean
+        double m2 = 0.0;        // running sum of squared differences from the mean
+        double min = 0.0;       // smallest value so far
+        double max = 0.0;       // largest value so far
+
+    public:
+        void add(double x);
+        void merge(const Welford& other);
+
+        uint64_t get_count() const;
+        double get_mean() const;
+        double get_variance() const;
+        double get_min() const;
+        double get_max() const;
+};
+
+
+// class for approximate quantiles of non-negative values, within a relative error, in bounded memory
+class QuantileSketch
+{
+    public:
+        static constexpr double ALPHA = 0.01;       // relative accuracy of every quantile
+
+    private:
+        static constexpr size_t MAX_BUCKETS = 2048; // the lowest buckets are collapsed beyond this
+
+        double log_gamma;                           // log of the ratio between consecutive bucket bounds
+        std::map<int32_t, uint64_t> buckets;        // count of values per bucket index, in order
+        uint64_t zero_count = 0;                    // values too small to have a bucket (0 and below)
+        uint64_t count = 0;                         // total number of values
+
+        int32_t index(double x) const;
+        void collapse();
+
+    public:
+        QuantileSketch();
+
+        void add(double x);
+        void merge(const QuantileSketch& other);
+
+        double value(int32_t i) const;
+        double quantile(double q) const;
+        uint64_t get_count() const;
+        uint64_t get_zero_count() const;
+        const std::map<int32_t, uint64_t>& get_buckets() const;
+};
+
+
+// class for everything kept about one metric
+class Statistic
+{
+    private:
+        Welford moments;        // exact count, mean, variance and extremes
+        QuantileSketch sketch;  // approximate quantiles
+
+    public:
+        void add(double x);
+        void merge(const Statistic& other);
+
+        const Welford& get_moments() const;
+        double quantile(double q) const;
+        void print_histogram(uint32_t bins) const;
+};
+
+
+// class for summarizing any number of challenges in constant memory
+class TrialStats
+{
+    private:
+        static const inline uint8_t NUM_METRICS = 5;    // entries, flips, seconds, coverage, CPU seconds
+
+        uint64_t trials = 0;                // number of challenges recorded
+        uint64_t successes = 0;             // number of them in which the claim was correct
+        Statistic metrics[NUM_METRICS];     // one per metric, in the order above
+        Welford weighted_failures;          // weight of each failed trial, 0 for successes
+
+    public:
+        void record(const ChallengeResult& result);
+        void merge(const TrialStats& other);
+
+        uint64_t get_trials() const;
+        uint64_t get_successes() const;
+        const Statistic& get_entries() const;
+        const Statistic& get_flips() const;
+        const Statistic& get_seconds() const;
+        const Statistic& get_coverage() const;
+        const Statistic& get_cpu_seconds() const;
+        const Welford& get_weighted_failures() const;
+
+        void print() const;
+};
+
+#endif // STATS_H
@@ -6,58 +6,111 @@ Isaac Jung
 | than a single switch. Therefore, there are two classes defined in this file, one for the SwitchRoom, one  |
 | for the Switch, in which the SwitchRoom is in a "has a" relationship with the Switch (composition); that  |
 | is, in this program, a Switch instance should not be instantiated outside of a SwitchRoom instance, and   |
-| when the SwitchRoom is deleted, the Switch should be, too.                                                |
+| when the SwitchRoom is deleted, the Switch should be, too. The Switch is held by value, so that a room    |
+| owns no memory of its own and can be created inside the prison's arena. The Switch is a template on its   |
+| number of positions, which is fixed when the program is compiled (see "make dial"): the usual switch has  |
+| 2, off and on, while a dial with more lets a setter turn it up several steps in one visit, and lets the   |
+| resetter count all of them at once by turning it back to 0.                                               |
 |===========================================================================================================|
 */
 
 #ifndef SWITCH_H
 #define SWITCH_H
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include "enums.h"
+#include "global.h"
 
 class Prisoner;     // comes from Prisoner.h, but must be forward declared to avoid circular includes
+class Handoff;      // comes from handoff.h, only needed as a pointer here
+class ProcessKey;   // comes from processes.h, only needed as a pointer here
 
 class SwitchRoom;
-class Switch;
+template <uint8_t M> class Switch;
 
 
-// class for the room containing the switch
+// class for the switch itself; only ever written by the room's occupant, so it gets its own cache line
+template <uint8_t M>
+class CACHE_ALIGNED Switch
+{
+    static_assert(M >= 2, "a switch needs at least 2 positions");
+
+    private:
+        uint8_t position;   // how far the switch is turned, from 0 (off) to TOP
+
+    public:
+        static const uint8_t TOP = M - 1;   // position the switch can't be turned past; for 2 positions, on
+
+        /**
+         * @brief CONSTRUCTOR - Initializes the object.
+         *
+         * @param initial_position Initial position of the switch, from 0 to TOP.
+         */
+        Switch(uint8_t initial_position = 0) : position(initial_position) {}
+
+        /**
+         * @brief GETTER - Checks how far the switch is turned.
+         *
+         * @return Returns the position of the switch, from 0 to TOP.
+         */
+        uint8_t get_position() const
+        {
+            return this->position;
+        }
+
+        /**
+         * @brief TOGGLER - Turns the switch to another position; with 2 positions, this flips it.
+         *
+         * @param to New position of the switch, from 0 to TOP.
+         */
+        void turn(uint8_t to)
+        {
+            this->position = to;
+        }
+};
+
+using RoomSwitch = Switch<Global::POSITIONS>;   // the switch every room has, as this build was compiled
+
+
+// class for the room containing the switch; the lock and the occupant's state live on separate cache lines
 class SwitchRoom
 {
     private:
-        Switch* s;                              // actual switch object
-        std::mutex key;                         // prevents entering the room when already occupied
-        Prisoner* current_occupant = nullptr;   // prisoner currently inside
+        RoomSwitch s;                           // actual switch object, on its own cache line
+        Handoff* handoff = nullptr;             // replaces key when the warden is handoff
+        ProcessKey* process_key = nullptr;      // replaces key when the warden is process
+        std::atomic<uint64_t>* sequence = nullptr;  // entries into every room, when there are several
+        CACHE_ALIGNED std::mutex key;           // prevents entering the room when already occupied
+        CACHE_ALIGNED Prisoner* current_occupant = nullptr; // prisoner currently inside
         uint64_t entered_count = 0;             // total number of prisoners to enter the room
         uint32_t flipped_count = 0;             // total number of flips of the switch
+        uint32_t parked_count = 0;              // number of finished setters who stopped visiting
+        const uint32_t population;              // number of prisoners who could visit
+        uint32_t distinct_visitors = 0;         // number of prisoners who have been in at least once
+        uint64_t coverage_entry = 0;            // entry of the prison on which the last of them first got in
     
     public:
-        SwitchRoom(switch_state initial_state = switch_state::off);
+        SwitchRoom(uint8_t initial_position = 0, uint32_t number_of_prisoners = 0);
         ~SwitchRoom();
 
+        void set_handoff(Handoff* h);
+        void set_process_key(ProcessKey* k);
+        void set_sequence(std::atomic<uint64_t>* q);
+
         void unlock(Prisoner *prisoner);
         void enter(Prisoner* prisoner);
-        switch_state check_switch(Prisoner* prisoner);
-        void flip_switch(Prisoner* prisoner);
+        bool check_switch(Prisoner* prisoner, uint8_t* position);
+        void turn_switch(Prisoner* prisoner, uint8_t to);
         void exit(Prisoner* prisoner, std::string description = "");
         void lock(Prisoner *prisoner);
+        void park(Prisoner* prisoner);
         uint64_t get_entered_count();
         uint32_t get_flipped_count();
-};
-
-
-// class for the switch itself
-class Switch
-{
-    private:
-        switch_state state; // state of the switch; on or off
-
-    public:
-        Switch(switch_state initial_state = switch_state::off);
-
-        bool is_on();
-        void flip();
+        uint32_t get_parked_count();
+        uint64_t get_coverage_entry();
+        uint32_t get_recovered_count();
 };
 
 #endif // SWITCH_H
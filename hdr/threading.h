@@ -0,0 +1,90 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for controlling how prisoner threads are run by the OS. It is only    |
+| relevant when the warden is the OS. Each prisoner thread should call apply_scheduling() on itself before  |
+| it starts performing its task, so that the scheduling policy, nice value, and priority requested on the   |
+| command line take effect for that thread alone. Requests that the OS refuses (for example, real-time      |
+| policies without the needed privileges) are reported once per challenge for each kind of request, and     |
+| otherwise ignored. This class also holds the start gate: each prisoner thread parks itself in gate_wait() |
+| with a ticket (its creation order), the main thread waits in gate_await() until every thread has arrived, |
+| and then gate_release() lets them go, either all at once or one ticket at a time. Finally, it holds the   |
+| parking lot, where setters who have nothing left to do can sleep in park_wait() until park_release() is   |
+| called at the end of the challenge. Every challenge has gates of its own, which all of its threads adopt, |
+| so that challenges run on different threads never let each other's prisoners through. Prisoner threads    |
+| are created with spawn(), which gives them a small stack of a configurable size, so that a hundred        |
+| thousand of them fit; thread_capacity() checks the OS's limits before any of them are created.            |
+|===========================================================================================================|
+*/
+
+#ifndef THREADING_H
+#define THREADING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <pthread.h>
+#include <string>
+#include "enums.h"
+
+class Threading;
+
+
+// class for controlling the OS-level behavior of prisoner threads
+class Threading
+{
+    public:
+        // kinds of scheduling requests the OS may refuse, each reported once per challenge
+        enum refusal {
+            r_policy    = 0,
+            r_nice      = 1,
+            r_pin       = 2,
+            r_kinds     = 3
+        };
+
+        // the start gate and parking lot of one challenge, both closed to begin with
+        struct Gates
+        {
+            std::mutex gate_mutex;              // protects the start gate counters
+            std::condition_variable gate_cv;    // signals arrivals and releases at the start gate
+            uint32_t arrived = 0;               // number of threads parked at the start gate
+            uint32_t released = 0;              // tickets below this may pass the start gate
+            std::mutex park_mutex;              // protects the parking lot state
+            std::condition_variable park_cv;    // tells parked threads the challenge is over
+            bool park_open = false;             // true once parked threads may leave
+            uint64_t parked_ns = 0;             // time every thread spent parked, added up as each leaves
+            std::atomic<bool> warned[r_kinds] = {}; // whether each kind of refusal has been reported
+        };
+
+    private:
+        static inline bool hushed = false;                  // set in prisoner processes that leave reports be
+        static inline thread_local Gates* gates = nullptr;  // those of the challenge the calling thread is in
+        static const inline uint64_t THREAD_MEMORY = 32 * 1024; // estimated bytes each thread really uses
+
+        static int32_t to_native_policy(sched_policy policy);
+        static void warn(refusal kind, const std::string& message);
+        static uint64_t read_number(const std::string& path, const std::string& key = "");
+        static void* run_task(void* task);
+
+    public:
+        static void apply_scheduling(bool resetter);
+        static void pin(uint32_t ticket);
+        static std::string policy_name(int32_t native_policy);
+        static void hush();
+
+        static Gates* adopt(Gates* challenge);
+        static void gate_wait(uint32_t ticket);
+        static void gate_await(uint32_t count);
+        static void gate_release(uint32_t count, int32_t stagger);
+
+        static void park_wait();
+        static void park_release();
+
+        static uint64_t thread_capacity(size_t stack_bytes, std::string* limit);
+        static int32_t spawn(pthread_t* thread, std::function<void()>* task, size_t stack_bytes);
+};
+
+#endif // THREADING_H
@@ -0,0 +1,86 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for timing each phase of the program separately. All times are taken  |
+| from a monotonic clock. The main program and the prison mark the beginning and end of each phase, which   |
+| is cheap enough to always do; the breakdown is only printed when the user asks for it. Besides the phases |
+| themselves, two events are recorded: the first time anyone enters the switch room, and the moment the     |
+| last prisoner thread actually started running (only meaningful when the warden is the OS). Phases that    |
+| happen once per trial add up across trials, while the two events describe the most recent trial. Trials  |
+| run by parallel workers each time their own phases, and their times add up in the same totals. A run of   |
+| the simulator keeps its times in Clocks of its own, which every thread it starts adopts, and adds them to |
+| the caller's once it is over, so that runs on different threads don't mix their times.                    |
+|===========================================================================================================|
+*/
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+class Timing;
+
+/**
+ * @brief Phases of the program that are timed separately.
+ * 
+ * @param ph_parse Parsing the command line.
+ * @param ph_init Creating the prisoners and the switch room.
+ * @param ph_spawn Shuffling the prisoners and, for the OS warden, creating their threads.
+ * @param ph_contest From the end of the spawn phase until a prisoner declares completion and everyone stops.
+ * @param ph_verify Checking whether every prisoner really did visit the switch room.
+ * @param ph_teardown Freeing the prisoners and the switch room.
+ */
+enum phase {
+    ph_parse    = 0,
+    ph_init     = 1,
+    ph_spawn    = 2,
+    ph_contest  = 3,
+    ph_verify   = 4,
+    ph_teardown = 5
+};
+
+
+// class for timing the phases of the program
+class Timing
+{
+    private:
+        using clock = std::chrono::steady_clock;
+
+        static const inline uint8_t NUM_PHASES = 6;                 // number of values in the phase enum
+        static inline thread_local clock::time_point begins[NUM_PHASES];    // when each phase last began
+
+    public:
+        // everything one run has measured; threads of the same run share one
+        struct Clocks
+        {
+            std::atomic<int64_t> totals[NUM_PHASES] = {};      // ns spent in each phase so far
+            std::atomic<clock::rep> spawn_began = 0;            // clock ticks when spawn last began
+            std::atomic<int64_t> first_entry = -1;              // ns after spawn began, -1 if none yet
+            std::atomic<int64_t> last_thread_start = -1;        // ns after spawn began, -1 if none yet
+        };
+
+    private:
+        static Clocks process;                                      // used by threads that adopt no other
+        static inline thread_local Clocks* clocks = &process;       // the calling thread's run
+
+        static int64_t since_spawn();
+        static double seconds(clock::duration duration);
+
+    public:
+        static Clocks* current();
+        static Clocks* adopt(Clocks* run);
+        static void absorb(const Clocks& run);
+
+        static void begin(phase p);
+        static void end(phase p);
+        static void mark_first_entry();
+        static void mark_thread_start();
+        static double duration(phase p);
+
+        static void print();
+};
+
+#endif // TIMING_H
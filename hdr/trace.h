@@ -0,0 +1,86 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This header contains a class used for recording a timeline of what every thread did, and exporting it   |
+| as Chrome trace-event JSON, which trace viewers such as Perfetto or chrome://tracing can open. Each thread |
+| appends events to a buffer of its own, so recording takes no locks and prints nothing while the challenge |
+| runs; everything is written out at the end. Trace points are placed with the TRACE_* macros below, which  |
+| cost one predictable branch when tracing is off, and nothing at all when compiled with -DNO_TRACE (see    |
+| "make notrace").                                                                                          |
+|===========================================================================================================|
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Trace;
+
+#ifdef NO_TRACE
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_THREAD(name)
+#else
+#define TRACE_BEGIN(name) do { if (Trace::enabled) Trace::begin(name); } while (0)
+#define TRACE_END(name) do { if (Trace::enabled) Trace::end(name); } while (0)
+#define TRACE_THREAD(name) do { if (Trace::enabled) Trace::name_thread(name); } while (0)
+#endif
+
+
+// static class for recording per thread timelines and writing them out as a Chrome trace
+class Trace
+{
+    private:
+        using clock = std::chrono::steady_clock;
+
+        static const inline size_t MAX_EVENTS = 1 << 20;   // events kept per thread; later ones are dropped
+
+        // one event; names must be string literals, since only the pointer is kept
+        struct Event
+        {
+            const char* name;   // what the thread was doing
+            char phase;         // 'B' when it began, 'E' when it ended
+            int64_t time;       // ns since the trace was opened
+        };
+
+        // everything one thread recorded
+        struct Buffer
+        {
+            uint32_t tid;               // small number standing in for the thread, in order of first event
+            std::string thread_name;    // shown by the viewer instead of the number, if set
+            std::vector<Event> events;  // in the order they happened
+            uint64_t dropped = 0;       // events past MAX_EVENTS that were not kept
+        };
+
+        static inline std::string path = "";                            // file the trace is written to
+        static inline std::ofstream file;                               // opened on it before the run starts
+        static inline clock::time_point opened;                         // time 0 of the trace
+        static inline std::mutex m;                                     // protects buffers
+        static inline std::vector<std::unique_ptr<Buffer>> buffers;     // every thread's, outliving them
+        static inline std::atomic<uint64_t> generation = 0;             // bumped by every open()
+        static inline thread_local Buffer* local = nullptr;             // the calling thread's, if current
+        static inline thread_local uint64_t local_generation = 0;       // trace that local belongs to
+
+        static Buffer* get_local();
+        static void record(const char* name, char phase);
+
+    public:
+        static inline bool enabled = false;     // set once before any threads start, read by the macros
+
+        static void open();
+        static void begin(const char* name);
+        static void end(const char* name);
+        static void name_thread(const std::string& name);
+        static void close();
+};
+
+#endif // TRACE_H
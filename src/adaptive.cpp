@@ -0,0 +1,153 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for adaptive.h.                                                   |
+|===========================================================================================================|
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "adaptive.h"
+#include "ensemble.h"
+#include "parser.h"
+#include "prison.h"
+#include "records.h"
+#include "timing.h"
+
+/**
+ * @brief SUB METHOD - Runs trials on every worker until the stopping rule is met or the budget runs out.
+ *
+ * @details Worker 0 seeds its prison with the seed itself, so a single worker reproduces the same trials as
+ * a plain run with the same seed; other workers get streams mixed from the seed and their number.
+ *
+ * @return Returns the summary of every trial that was run, which may be a few batches past the point where
+ * the rule was first met, since workers finish the batch they are on.
+ */
+TrialStats Adaptive::run()
+{
+    uint32_t workers = Parser::get_workers();
+    uint64_t budget = Parser::get_budget();
+    std::atomic<uint64_t> claimed = 0;      // trials handed out so far
+    std::atomic<bool> stop = false;         // set once the stopping rule is met
+    std::mutex total_mutex;                 // protects total
+    TrialStats total;
+    const Config* config = &Parser::get_config();
+    Timing::Clocks* clocks = Timing::current();
+
+    auto work = [&](uint32_t stream) {
+        Parser::adopt(config);      // workers take part in the same run as the thread that started them
+        Timing::adopt(clocks);
+        bool first = true;
+        std::unique_ptr<Ensemble> ensemble;     // runs the worker's batches instead of the prison, if on
+        if (Parser::ensemble_is_on())
+            ensemble = std::make_unique<Ensemble>(Parser::get_ensemble_mode(),
+                Parser::get_number_of_prisoners());
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint64_t from = claimed.fetch_add(Adaptive::BATCH, std::memory_order_relaxed);
+            if (from >= budget) break;
+            uint64_t count = std::min<uint64_t>(Adaptive::BATCH, budget - from);
+            TrialStats local;
+            if (ensemble) ensemble->run(from, count, stream, &local, nullptr);
+            else for (uint64_t trial = 0; trial < count; trial++) {
+                Timing::begin(phase::ph_init);
+                if (first) Prison::init(stream);
+                else Prison::reset();
+                Timing::end(phase::ph_init);
+                first = false;
+                Prison::challenge();
+                local.record(Prison::last_result());
+                Records::write(Prison::last_result(), from + trial, stream);
+            }
+            std::lock_guard<std::mutex> guard(total_mutex);
+            total.merge(local);
+            if (Adaptive::precise_enough(total)) stop.store(true, std::memory_order_relaxed);
+        }
+        if (!first) Prison::free_memory();
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t stream = 1; stream < workers; stream++) threads.push_back(std::thread(work, stream));
+    work(0);
+    for (std::thread& thread : threads) thread.join();
+    return total;
+}
+
+/**
+ * @brief HELPER - Checks whether every interval that has a target is narrower than it.
+ *
+ * @param stats Summary of the trials so far.
+ * @return Returns true once there is at least one batch of trials and every target is met.
+ */
+bool Adaptive::precise_enough(const TrialStats& stats)
+{
+    if (stats.get_trials() < Adaptive::BATCH) return false;
+    double ci = Parser::get_ci();
+    if (ci > 0.0 && Adaptive::success_half_width(stats) > ci) return false;
+    double entries_ci = Parser::get_entries_ci();
+    const Welford& entries = stats.get_entries().get_moments();
+    if (entries_ci > 0.0 && Adaptive::t_half_width(entries) > entries_ci * entries.get_mean()) return false;
+    return true;
+}
+
+/**
+ * @brief GETTER - Computes the half-width of the 95% interval of the success rate.
+ *
+ * @details With importance sampling, successes can't simply be counted, so the interval comes from the
+ * standard error of the weighted failures instead (the failure rate's interval is as wide as the success
+ * rate's). Otherwise, it is the Wilson interval.
+ *
+ * @param stats Summary of the trials so far.
+ * @return Returns the half-width.
+ */
+double Adaptive::success_half_width(const TrialStats& stats)
+{
+    if (!Parser::importance_is_on())
+        return Adaptive::wilson_half_width(stats.get_successes(), stats.get_trials());
+    const Welford& failures = stats.get_weighted_failures();
+    if (failures.get_count() < 2) return 1.0;
+    return Adaptive::Z * std::sqrt(failures.get_variance() / static_cast<double>(failures.get_count()));
+}
+
+/**
+ * @brief GETTER - Computes the half-width of the 95% Wilson score interval of a success rate.
+ *
+ * @details Unlike the plain normal interval, this stays sensible when the rate is close to 0 or 1, which is
+ * exactly where the improper strategy tends to be.
+ *
+ * @param successes Number of successful trials.
+ * @param trials Number of trials in total.
+ * @return Returns the half-width, or 1 when there are no trials.
+ */
+double Adaptive::wilson_half_width(uint64_t successes, uint64_t trials)
+{
+    if (trials == 0) return 1.0;
+    double n = static_cast<double>(trials);
+    double p = static_cast<double>(successes) / n;
+    double z2 = Adaptive::Z * Adaptive::Z;
+    return Adaptive::Z / (1.0 + z2 / n) * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n));
+}
+
+/**
+ * @brief GETTER - Computes the half-width of the 95% t-interval of a mean.
+ *
+ * @details The t quantile comes from the Cornish-Fisher expansion around the normal one, which is accurate
+ * to well under 1% from 10 degrees of freedom on, and the stopping rule never looks at fewer values.
+ *
+ * @param moments Moments of the values.
+ * @return Returns the half-width, or infinity when there are fewer than 2 values.
+ */
+double Adaptive::t_half_width(const Welford& moments)
+{
+    if (moments.get_count() < 2) return INFINITY;
+    double df = static_cast<double>(moments.get_count() - 1);
+    double z = Adaptive::Z;
+    double t = z + (z * z * z + z) / (4.0 * df) +
+        (5.0 * std::pow(z, 5) + 16.0 * z * z * z + 3.0 * z) / (96.0 * df * df);
+    return t * std::sqrt(moments.get_variance() / static_cast<double>(moments.get_count()));
+}
@@ -0,0 +1,78 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for alias.h.                                                      |
+|===========================================================================================================|
+*/
+
+#include <stdexcept>
+#include "alias.h"
+
+/**
+ * @brief CONSTRUCTOR - Builds the alias table from a list of weights, in linear time.
+ *
+ * @details Each weight is scaled so that the average is 1. Columns below 1 ("small") are topped up by
+ * columns above 1 ("large"), which become their aliases, until every column holds exactly 1.
+ *
+ * @param weights Non-negative weights, one per index; they do not need to sum to anything in particular.
+ * @throws std::invalid_argument When there are no weights, a weight is negative, or they sum to 0.
+ */
+AliasTable::AliasTable(const std::vector<double>& weights) : probability(weights.size(), 1.0),
+    alias(weights.size(), 0), column(0, weights.empty() ? 0 : static_cast<uint32_t>(weights.size() - 1)),
+    coin(0.0, 1.0)
+{
+    if (weights.empty()) throw std::invalid_argument("AliasTable needs at least one weight");
+    double sum = 0.0;
+    for (double weight : weights) {
+        if (weight < 0.0) throw std::invalid_argument("AliasTable weights must not be negative");
+        sum += weight;
+    }
+    if (sum <= 0.0) throw std::invalid_argument("AliasTable weights must not all be 0");
+
+    uint32_t n = static_cast<uint32_t>(weights.size());
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (uint32_t i = 0; i < n; i++) {
+        scaled.at(i) = weights.at(i) * n / sum;
+        if (scaled.at(i) < 1.0) small.push_back(i);
+        else large.push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back();
+        uint32_t l = large.back();
+        small.pop_back();
+        this->probability.at(s) = scaled.at(s);
+        this->alias.at(s) = l;
+        scaled.at(l) -= 1.0 - scaled.at(s);
+        if (scaled.at(l) < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // anything left over is 1 up to rounding error, so it keeps its own column
+    for (uint32_t i : small) this->probability.at(i) = 1.0;
+    for (uint32_t i : large) this->probability.at(i) = 1.0;
+}
+
+/**
+ * @brief GETTER - Draws an index with probability proportional to its weight, in constant time.
+ *
+ * @param mt Mersenne Twister to draw from.
+ * @return Returns an index from 0 to size() - 1.
+ */
+uint32_t AliasTable::sample(std::mt19937& mt)
+{
+    uint32_t i = this->column(mt);
+    return this->coin(mt) < this->probability[i] ? i : this->alias[i];
+}
+
+/**
+ * @brief GETTER - Interface for getting the number of indices in the table.
+ *
+ * @return Returns the number of weights the table was built from.
+ */
+uint32_t AliasTable::size() const
+{
+    return static_cast<uint32_t>(this->probability.size());
+}
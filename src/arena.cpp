@@ -0,0 +1,132 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for arena.h.                                                      |
+|===========================================================================================================|
+*/
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "arena.h"
+#include "global.h"
+
+/**
+ * @brief HELPER - Maps a POSIX shared memory segment, which is unlinked right away, so that only the
+ * calling process and the processes it forks afterwards can ever reach it.
+ *
+ * @param bytes Size of the segment.
+ * @return Returns the start of the mapping, which is page aligned.
+ * @throws std::runtime_error When the OS won't create or map the segment.
+ */
+char* Arena::map_shared(size_t bytes)
+{
+    static std::atomic<uint32_t> segments{0};  // several workers may each want a segment at once
+    std::string name = "/prisoners-" + std::to_string(Global::PID) + "-" + std::to_string(segments++);
+    int32_t fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw std::runtime_error("Could not create shared memory " + name + " (" +
+        std::strerror(errno) + ")");
+    shm_unlink(name.c_str());
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+        mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int32_t err = errno;
+    close(fd);
+    if (mapped == MAP_FAILED) throw std::runtime_error("Could not map " + std::to_string(bytes) +
+        " bytes of shared memory (" + std::strerror(err) + ")");
+    return static_cast<char*>(mapped);
+}
+
+/**
+ * @brief CONSTRUCTOR - Allocates the block that every object in the arena will be carved from.
+ *
+ * @param bytes Size of the block; it cannot grow later.
+ * @param shared_memory Whether the block should be shared memory, which processes forked later keep sharing.
+ * @throws std::runtime_error When shared memory is asked for, but the OS won't provide it.
+ */
+Arena::Arena(size_t bytes, bool shared_memory) : capacity(bytes), shared(shared_memory),
+    block(shared_memory ? Arena::map_shared(bytes) :
+        static_cast<char*>(::operator new(bytes, std::align_val_t(Global::CACHE_LINE)))) {}
+
+/**
+ * @brief DECONSTRUCTOR - Frees the block. Destructors of objects inside are not called.
+ */
+Arena::~Arena()
+{
+    if (this->shared) munmap(this->block, this->capacity);
+    else ::operator delete(this->block, std::align_val_t(Global::CACHE_LINE));
+}
+
+/**
+ * @brief ALLOCATOR - Hands out the next piece of the block, in constant time.
+ *
+ * @param bytes Number of bytes needed.
+ * @param alignment Required alignment, which must be a power of 2 no larger than a cache line.
+ * @return Returns a pointer to uninitialized memory inside the block.
+ * @throws std::bad_alloc When the block does not have enough room left.
+ */
+void* Arena::allocate(size_t bytes, size_t alignment)
+{
+    size_t start = (this->used + alignment - 1) & ~(alignment - 1);
+    if (start + bytes > this->capacity) throw std::bad_alloc();
+    this->used = start + bytes;
+    return this->block + start;
+}
+
+/**
+ * @brief GETTER - Interface for getting a mark that rewind() can later go back to.
+ *
+ * @return Returns the number of bytes used so far.
+ */
+size_t Arena::mark() const
+{
+    return this->used;
+}
+
+/**
+ * @brief DELETER - Releases everything allocated after the mark, in constant time.
+ *
+ * @param to Mark obtained from mark(); objects created after it must not be used anymore.
+ * @throws std::logic_error When the mark is past what is currently used.
+ */
+void Arena::rewind(size_t to)
+{
+    if (to > this->used) throw std::logic_error("Arena::rewind() given a mark past the used space");
+    this->used = to;
+}
+
+/**
+ * @brief GETTER - Interface for getting how much of the block is currently handed out.
+ *
+ * @return Returns a number of bytes, including alignment padding.
+ */
+size_t Arena::get_used() const
+{
+    return this->used;
+}
+
+/**
+ * @brief GETTER - Interface for getting the size of the block.
+ *
+ * @return Returns a number of bytes.
+ */
+size_t Arena::get_capacity() const
+{
+    return this->capacity;
+}
+
+/**
+ * @brief GETTER - Interface for getting whether the block is shared memory.
+ *
+ * @return Returns true when the block is kept by processes forked after the arena was created.
+ */
+bool Arena::is_shared() const
+{
+    return this->shared;
+}
@@ -0,0 +1,92 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for cfs.h.                                                       |
+|===========================================================================================================|
+*/
+
+#include <stdexcept>
+#include "cfs.h"
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object, with every prisoner runnable and no one having run yet.
+ *
+ * @details Ties in virtual runtime are broken by position, so the prison's (seeded) shuffle decides who
+ * runs first, just like thread creation order would.
+ *
+ * @param number_of_prisoners Number of prisoners to schedule, at positions 0 to number_of_prisoners - 1.
+ * @param granularity Minimum time slice in nanoseconds.
+ * @param cost Time one visit to the room takes in nanoseconds.
+ * @throws std::invalid_argument When there are no prisoners, or the visit cost is 0.
+ */
+FairScheduler::FairScheduler(uint32_t number_of_prisoners, uint64_t granularity, uint64_t cost) :
+    slice(number_of_prisoners == 0 || FairScheduler::TARGET_LATENCY / number_of_prisoners < granularity ?
+        granularity : FairScheduler::TARGET_LATENCY / number_of_prisoners), visit_cost(cost),
+    vruntime(number_of_prisoners, 0)
+{
+    if (number_of_prisoners == 0) throw std::invalid_argument("FairScheduler needs at least one prisoner");
+    if (cost == 0) throw std::invalid_argument("FairScheduler needs a positive visit cost");
+    for (uint32_t index = 0; index < number_of_prisoners; index++) this->runnable.insert({0, index});
+}
+
+/**
+ * @brief GETTER - Takes the prisoner with the least virtual runtime off the runnable tree to run next.
+ *
+ * @param visits Where to store how many visits fit in that prisoner's time slice (always at least 1).
+ * @return Returns the position of the prisoner who runs next; they must be handed back with preempt().
+ */
+uint32_t FairScheduler::pick(uint64_t* visits)
+{
+    auto leftmost = this->runnable.begin();
+    uint32_t index = leftmost->second;
+    this->runnable.erase(leftmost);
+    this->slices++;
+    *visits = this->slice / this->visit_cost > 0 ? this->slice / this->visit_cost : 1;
+    return index;
+}
+
+/**
+ * @brief SETTER - Charges a prisoner for the visits they made and puts them back on the runnable tree.
+ *
+ * @param index Position of the prisoner, as returned by pick().
+ * @param visits_made How many visits they actually made, which can be fewer than allowed if the challenge
+ * ended during their slice.
+ */
+void FairScheduler::preempt(uint32_t index, uint64_t visits_made)
+{
+    uint64_t ran = visits_made * this->visit_cost;
+    this->clock += ran;
+    this->vruntime[index] += ran;
+    this->runnable.insert({this->vruntime[index], index});
+}
+
+/**
+ * @brief GETTER - Interface for getting how much CPU time the emulated scheduler has handed out.
+ *
+ * @return Returns a number of nanoseconds.
+ */
+uint64_t FairScheduler::get_clock() const
+{
+    return this->clock;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many time slices the emulated scheduler has handed out.
+ *
+ * @return Returns the number of calls to pick(), which is the number of emulated context switches.
+ */
+uint64_t FairScheduler::get_slice_count() const
+{
+    return this->slices;
+}
+
+/**
+ * @brief GETTER - Interface for getting the length of each time slice.
+ *
+ * @return Returns a number of nanoseconds.
+ */
+uint64_t FairScheduler::get_slice() const
+{
+    return this->slice;
+}
@@ -0,0 +1,394 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for coroutines.h.                                                 |
+|===========================================================================================================|
+*/
+
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include "coroutines.h"
+#include "parser.h"
+#include "timing.h"
+#include "trace.h"
+
+
+/*================================================= Task ==================================================*/
+
+/**
+ * @brief FACTORY - Hands the caller of a prisoner's coroutine the handle to it.
+ *
+ * @return Returns the task, holding the handle.
+ */
+Coroutines::Task Coroutines::Task::promise_type::get_return_object()
+{
+    return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+}
+
+/**
+ * @brief SEMAPHORE - Keeps a new prisoner from running until the pool resumes them.
+ */
+std::suspend_always Coroutines::Task::promise_type::initial_suspend() noexcept
+{
+    return {};
+}
+
+/**
+ * @brief SEMAPHORE - Keeps a finished prisoner's frame around, so that the pool destroys every frame alike.
+ */
+std::suspend_always Coroutines::Task::promise_type::final_suspend() noexcept
+{
+    return {};
+}
+
+/**
+ * @brief CLOSER - Called when a prisoner's coroutine returns; there is nothing to hand back.
+ */
+void Coroutines::Task::promise_type::return_void() {}
+
+/**
+ * @brief HELPER - Keeps what a prisoner threw for the thread that resumed them, which ends the challenge.
+ */
+void Coroutines::Task::promise_type::unhandled_exception()
+{
+    Coroutines::failure = std::current_exception();
+}
+
+
+/*============================================ Entry and Backoff ==========================================*/
+
+/**
+ * @brief SEMAPHORE - Always goes on to await_suspend(), which decides whether to wait.
+ *
+ * @return Returns false.
+ */
+bool Coroutines::Entry::await_ready() const noexcept
+{
+    return false;
+}
+
+/**
+ * @brief SEMAPHORE - Takes the room if it is free, and otherwise joins those waiting for it.
+ *
+ * @details Once the prisoner is waiting, they may be handed the room and resumed by another thread at any
+ * moment, so nothing here may touch the prisoner's frame, this awaiter included, after enter() returns.
+ *
+ * @param waiter The prisoner's coroutine.
+ * @return Returns true when the prisoner must wait, false when they hold the room and go straight on.
+ */
+bool Coroutines::Entry::await_suspend(Handle waiter) const
+{
+    return this->pool->enter(this->index);
+}
+
+/**
+ * @brief SEMAPHORE - Called once the prisoner holds the room; there is nothing to hand back.
+ */
+void Coroutines::Entry::await_resume() const noexcept {}
+
+/**
+ * @brief SEMAPHORE - Always goes on to await_suspend(), so the prisoner always backs off.
+ *
+ * @return Returns false.
+ */
+bool Coroutines::Backoff::await_ready() const noexcept
+{
+    return false;
+}
+
+/**
+ * @brief SEMAPHORE - Puts the prisoner at the back of the calling thread's queue.
+ *
+ * @param waiter The prisoner's coroutine.
+ */
+void Coroutines::Backoff::await_suspend(Handle waiter) const
+{
+    this->pool->schedule(waiter);
+}
+
+/**
+ * @brief SEMAPHORE - Called once the prisoner is resumed; there is nothing to hand back.
+ */
+void Coroutines::Backoff::await_resume() const noexcept {}
+
+
+/*============================================== Coroutines ===============================================*/
+
+/**
+ * @brief CONSTRUCTOR - Creates every prisoner's coroutine, suspended, and deals them out to the threads.
+ *
+ * @details The coroutines are dealt out round robin in the order the prisoners are given in, so that with
+ * a shuffled prison, each thread starts with a random share of them.
+ *
+ * @param prisoners Every prisoner in the prison, the resetter included.
+ * @param room The switch room, which must be the only one.
+ * @param finished The challenge's flag, set by whoever declares the challenge over.
+ * @param threads Number of threads in the pool; no more than one per prisoner are used.
+ * @param p Policy for choosing who is resumed next, and who gets the room next among those waiting.
+ * @param seed Seed for the random policy.
+ */
+Coroutines::Coroutines(const std::vector<Prisoner*>& prisoners, SwitchRoom* room, bool* finished,
+    uint32_t threads, handoff_policy p, uint32_t seed) : challenge_finished(finished), policy(p),
+    workers(std::max<size_t>(1, std::min<size_t>(threads, prisoners.size()))), frames(prisoners.size() + 1),
+    waiting(static_cast<uint32_t>(prisoners.size()), p, seed)
+{
+    for (size_t id = 0; id < this->workers.size(); id++)
+        this->workers.at(id).mt.seed(static_cast<uint32_t>(seed + id + 1));
+    size_t id = 0;
+    for (Prisoner* prisoner : prisoners) {
+        Handle frame = this->visits(prisoner, room).handle;
+        this->frames.at(prisoner->get_index()) = frame;
+        this->workers.at(id).ready.push_back(frame);
+        id = (id + 1) % this->workers.size();
+    }
+}
+
+/**
+ * @brief DECONSTRUCTOR - Destroys every prisoner's coroutine, wherever it was suspended.
+ */
+Coroutines::~Coroutines()
+{
+    for (Handle frame : this->frames) {
+        if (frame) frame.destroy();
+    }
+}
+
+/**
+ * @brief SUB METHOD - The coroutine every prisoner runs, which mirrors the loop of a prisoner thread.
+ *
+ * @details Since the coro warden isn't threaded, each call to perform_task() is a single visit, and the
+ * room's own key is never contended, since nobody calls it without first holding the room here.
+ *
+ * @param p Prisoner to run.
+ * @param room The switch room.
+ * @return Returns the task holding the coroutine's handle.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-default"   // the compiler's own resume switch has no default case
+Coroutines::Task Coroutines::visits(Prisoner* p, SwitchRoom* room)
+{
+    uint32_t index = p->get_index();
+    while (!this->over.load(std::memory_order_relaxed)) {
+        co_await Entry{this, index};
+        p->perform_task(this->challenge_finished, room);
+        if (*this->challenge_finished) this->over.store(true, std::memory_order_relaxed);
+        this->leave(index);
+        co_await Backoff{this};
+    }
+}
+#pragma GCC diagnostic pop
+
+/**
+ * @brief SEMAPHORE - Lets a prisoner into the room if it is free, and otherwise has them wait for it.
+ *
+ * @param index Unique index of the prisoner.
+ * @return Returns true when the prisoner is now waiting, false when they hold the room.
+ */
+bool Coroutines::enter(uint32_t index)
+{
+    std::lock_guard<std::mutex> guard(this->room_mutex);
+    if (!this->occupied) {
+        this->occupied = true;
+        this->waiting.grant(index);
+        this->walk_ins++;
+        return false;
+    }
+    this->waiting.push(index);
+    return true;
+}
+
+/**
+ * @brief SEMAPHORE - Hands the room to exactly one waiting prisoner, who becomes ready to run, or leaves it
+ * free if nobody waits.
+ *
+ * @param index Unique index of the prisoner leaving the room.
+ */
+void Coroutines::leave(uint32_t index)
+{
+    Handle chosen;
+    {
+        std::lock_guard<std::mutex> guard(this->room_mutex);
+        this->waiting.leave(index);
+        if (this->waiting.empty()) {
+            this->occupied = false;
+            return;
+        }
+        uint32_t next = this->waiting.pop();
+        this->waiting.grant(next);
+        this->handoffs++;
+        chosen = this->frames.at(next);
+    }
+    this->schedule(chosen);
+}
+
+/**
+ * @brief SETTER - Puts a prisoner at the back of the calling thread's queue, to be resumed later.
+ *
+ * @param ready The prisoner's coroutine, which must be suspended or about to be.
+ */
+void Coroutines::schedule(Handle ready)
+{
+    Worker* self = Coroutines::local;
+    std::lock_guard<std::mutex> guard(self->m);
+    self->ready.push_back(ready);
+}
+
+/**
+ * @brief GETTER - Finds the next prisoner for a thread to resume: one from its own queue, picked at random
+ * under the random policy and the oldest otherwise, or failing that, the newest in the first other queue
+ * that isn't empty.
+ *
+ * @param id Which thread of the pool is asking.
+ * @return Returns the prisoner's coroutine, or a null handle when every queue is empty.
+ */
+Coroutines::Handle Coroutines::next(uint32_t id)
+{
+    Worker& self = this->workers.at(id);
+    {
+        std::lock_guard<std::mutex> guard(self.m);
+        if (!self.ready.empty()) {
+            if (this->policy == handoff_policy::h_random) {
+                std::uniform_int_distribution<size_t> dist(0, self.ready.size() - 1);
+                std::swap(self.ready.front(), self.ready.at(dist(self.mt)));
+            }
+            Handle ready = self.ready.front();
+            self.ready.pop_front();
+            return ready;
+        }
+    }
+    size_t count = this->workers.size();
+    for (size_t offset = 1; offset < count; offset++) {
+        Worker& victim = this->workers.at((id + offset) % count);
+        std::lock_guard<std::mutex> guard(victim.m);
+        if (victim.ready.empty()) continue;
+        Handle ready = victim.ready.back();
+        victim.ready.pop_back();
+        self.steals++;
+        return ready;
+    }
+    return Handle();
+}
+
+/**
+ * @brief HELPER - The loop every thread of the pool follows until the challenge is over.
+ *
+ * @details A thread that finds nothing to run, which happens when every prisoner but the one in the room is
+ * waiting for it, yields the CPU and looks again.
+ *
+ * @param id Which thread of the pool the calling thread is.
+ */
+void Coroutines::work(uint32_t id)
+{
+    Worker* self = &this->workers.at(id);
+    Coroutines::local = self;
+    Coroutines::failure = nullptr;
+    while (!this->over.load(std::memory_order_relaxed)) {
+        Handle ready = this->next(id);
+        if (!ready) {
+            std::this_thread::yield();
+            continue;
+        }
+        ready.resume();
+        self->resumes++;
+        if (Coroutines::failure) {
+            std::lock_guard<std::mutex> guard(this->room_mutex);
+            if (!this->error) this->error = Coroutines::failure;
+            this->over.store(true, std::memory_order_relaxed);
+        }
+    }
+    Coroutines::local = nullptr;
+}
+
+/**
+ * @brief SUB METHOD - Runs the prisoners until one declares the challenge over.
+ *
+ * @details The calling thread is the first thread of the pool, and the others are started here, taking
+ * part in the calling thread's run, with its configuration and clocks.
+ *
+ * @throws std::runtime_error When the threads of the pool can't be started, or whatever a prisoner threw.
+ */
+void Coroutines::run()
+{
+    const Config* config = &Parser::get_config();
+    Timing::Clocks* clocks = Timing::current();
+    auto work = [this, config, clocks](uint32_t id) {
+        Parser::adopt(config);
+        Timing::adopt(clocks);
+        Timing::mark_thread_start();
+        TRACE_THREAD("pool thread " + std::to_string(id));
+        this->work(id);
+    };
+
+    std::vector<std::thread> threads;
+    uint32_t count = static_cast<uint32_t>(this->workers.size());
+    try {
+        for (uint32_t id = 1; id < count; id++) threads.push_back(std::thread(work, id));
+    } catch (const std::system_error& e) {
+        this->over.store(true, std::memory_order_relaxed);
+        for (std::thread& thread : threads) thread.join();
+        throw std::runtime_error("Could only start " + std::to_string(threads.size() + 1) + " of " +
+            std::to_string(count) + " pool threads (" + e.what() + ")");
+    }
+    this->work(0);
+    for (std::thread& thread : threads) thread.join();
+    if (this->error) std::rethrow_exception(this->error);
+}
+
+/**
+ * @brief GETTER - Interface for getting how many threads are in the pool.
+ *
+ * @return Returns an integer greater than or equal to 1.
+ */
+uint32_t Coroutines::get_thread_count() const
+{
+    return static_cast<uint32_t>(this->workers.size());
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times the pool resumed a prisoner, all threads together.
+ *
+ * @return Returns an integer greater than or equal to 0; only final once run() has returned.
+ */
+uint64_t Coroutines::get_resume_count() const
+{
+    uint64_t total = 0;
+    for (const Worker& worker : this->workers) total += worker.resumes;
+    return total;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many prisoners a thread took from another thread's queue.
+ *
+ * @return Returns an integer greater than or equal to 0; only final once run() has returned.
+ */
+uint64_t Coroutines::get_steal_count() const
+{
+    uint64_t total = 0;
+    for (const Worker& worker : this->workers) total += worker.steals;
+    return total;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times the room was handed straight to a waiting prisoner.
+ *
+ * @return Returns an integer greater than or equal to 0; only final once run() has returned.
+ */
+uint64_t Coroutines::get_handoff_count() const
+{
+    return this->handoffs;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times a prisoner found the room free and walked in.
+ *
+ * @return Returns an integer greater than or equal to 0; only final once run() has returned.
+ */
+uint64_t Coroutines::get_walk_in_count() const
+{
+    return this->walk_ins;
+}
@@ -0,0 +1,213 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for counters.h.                                                   |
+|===========================================================================================================|
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "counters.h"
+#include "global.h"
+
+/**
+ * @brief SUB METHOD - Starts collecting counters. Should be called right before the challenge begins.
+ *
+ * @details Every perf event is opened on its own, so that a missing hardware event (common in virtual
+ * machines) does not prevent the software events from being counted.
+ */
+void Counters::start()
+{
+    const uint32_t types[NUM_EVENTS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE
+    };
+    const uint64_t configs[NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_CONTEXT_SWITCHES, PERF_COUNT_SW_CPU_MIGRATIONS
+    };
+    for (uint8_t i = 0; i < NUM_EVENTS; i++) {
+        Counters::fds[i] = Counters::open_event(types[i], configs[i]);
+        Counters::values[i] = 0;
+        Counters::read_ok[i] = false;
+    }
+    Counters::read_usage(&Counters::usage_start);
+    for (int32_t fd : Counters::fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    Counters::started = true;
+}
+
+/**
+ * @brief SUB METHOD - Stops collecting counters. Should be called right after the challenge ends.
+ *
+ * @details Counts are scaled by time enabled over time running, in case the kernel had to multiplex the
+ * hardware counters. Every file descriptor is closed again, so start() may be called for another run.
+ *
+ * @throws std::logic_error When start() hasn't been called first.
+ */
+void Counters::stop()
+{
+    if (!Counters::started) throw std::logic_error("Counters::start() must be called first");
+
+    for (int32_t fd : Counters::fds) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    Counters::read_usage(&Counters::usage_end);
+    for (uint8_t i = 0; i < NUM_EVENTS; i++) {
+        if (Counters::fds[i] < 0) continue;
+        uint64_t buffer[3] = {0, 0, 0};  // value, time enabled, time running
+        if (read(Counters::fds[i], buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer))) {
+            if (buffer[2] > 0 && buffer[2] < buffer[1])
+                buffer[0] = static_cast<uint64_t>(static_cast<double>(buffer[0]) *
+                    static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]));
+            Counters::values[i] = buffer[0];
+            Counters::read_ok[i] = true;
+        }
+        close(Counters::fds[i]);
+        Counters::fds[i] = -1;
+    }
+    Counters::started = false;
+}
+
+/**
+ * @brief GETTER - Interface for getting the CPU time (user plus system) used between start() and stop().
+ *
+ * @return Returns the CPU time of the whole process, in seconds, including every prisoner thread or process.
+ */
+double Counters::cpu_seconds()
+{
+    auto to_seconds = [](const timeval& tv) {
+        return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+    };
+    return to_seconds(Counters::usage_end.ru_utime) - to_seconds(Counters::usage_start.ru_utime) +
+        to_seconds(Counters::usage_end.ru_stime) - to_seconds(Counters::usage_start.ru_stime);
+}
+
+/**
+ * @brief GETTER - Interface for getting the CPU time (user plus system) the process has used so far.
+ *
+ * @details Unlike cpu_seconds(), this does not need start() and stop(), so it can be used for a quick
+ * before and after comparison even when counters are turned off.
+ *
+ * @return Returns the CPU time of the whole process, in seconds, including every thread and every prisoner
+ *  process that has been reaped.
+ */
+double Counters::process_cpu_seconds()
+{
+    rusage usage;
+    Counters::read_usage(&usage);
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+        static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+/**
+ * @brief SUB METHOD - Prints every collected counter, both in total and per room entry.
+ *
+ * @param entries Number of times the switch room was entered during the challenge; used for normalizing.
+ */
+void Counters::print(uint64_t entries)
+{
+    auto to_seconds = [](const timeval& tv) {
+        return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+    };
+    double per = entries > 0 ? 1.0 / static_cast<double>(entries) : 0.0;
+    auto row = [per](const std::string& name, double value, int32_t decimals) {
+        std::cout << "  " << std::left << std::setw(30) << name << std::right << std::setw(16) <<
+            std::fixed << std::setprecision(decimals) << value << std::setw(16) <<
+            std::setprecision(decimals + 3) << value * per << std::endl;
+    };
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << std::endl << "Performance counters (total, per room entry; " <<
+        (Global::PACKED ? "packed" : "cache-aligned") << " layout):" << std::endl;
+    uint8_t missing = 0;
+    for (uint8_t i = 0; i < NUM_EVENTS; i++) {
+        if (!Counters::read_ok[i]) missing++;
+        else row(Counters::names[i], static_cast<double>(Counters::values[i]), 0);
+    }
+    if (missing > 0) std::cout << "  (" << static_cast<uint32_t>(missing) << " of " <<
+        static_cast<uint32_t>(NUM_EVENTS) << " perf events unavailable on this system)" << std::endl;
+    row("user CPU time (s)",
+        to_seconds(Counters::usage_end.ru_utime) - to_seconds(Counters::usage_start.ru_utime), 6);
+    row("system CPU time (s)",
+        to_seconds(Counters::usage_end.ru_stime) - to_seconds(Counters::usage_start.ru_stime), 6);
+    row("voluntary context switches",
+        static_cast<double>(Counters::usage_end.ru_nvcsw - Counters::usage_start.ru_nvcsw), 0);
+    row("involuntary context switches",
+        static_cast<double>(Counters::usage_end.ru_nivcsw - Counters::usage_start.ru_nivcsw), 0);
+    // the peak is over the process's whole life, not the challenge, so it has no value per entry
+    std::cout << "  " << std::left << std::setw(30) << "peak RSS of the process (KiB)" << std::right <<
+        std::setw(16) << Counters::usage_end.ru_maxrss << std::endl;
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+/**
+ * @brief HELPER - Reads the resource usage of the process, adding in that of its reaped children.
+ *
+ * @details The process warden's prisoners are child processes, whose usage the OS only reports apart from
+ * the program's own; for threads, there are no children, so this is the same as the process alone. The
+ * peak RSS is the larger of the two, since children don't add to the program's memory.
+ *
+ * @param usage Where to put the combined usage.
+ */
+void Counters::read_usage(rusage* usage)
+{
+    rusage children;
+    getrusage(RUSAGE_SELF, usage);
+    getrusage(RUSAGE_CHILDREN, &children);
+    auto add = [](timeval& to, const timeval& from) {
+        to.tv_sec += from.tv_sec;
+        to.tv_usec += from.tv_usec;
+        if (to.tv_usec >= 1000000) {
+            to.tv_sec++;
+            to.tv_usec -= 1000000;
+        }
+    };
+    add(usage->ru_utime, children.ru_utime);
+    add(usage->ru_stime, children.ru_stime);
+    usage->ru_nvcsw += children.ru_nvcsw;
+    usage->ru_nivcsw += children.ru_nivcsw;
+    usage->ru_maxrss = std::max(usage->ru_maxrss, children.ru_maxrss);
+}
+
+/**
+ * @brief HELPER - Opens a single perf event counting the whole process, including threads created later.
+ *
+ * @details The event is first opened including kernel activity; if that is refused, it is retried counting
+ * user space only, which is what unprivileged users are usually allowed to do.
+ *
+ * @param type One of the PERF_TYPE_* constants.
+ * @param config One of the PERF_COUNT_* constants matching the type.
+ * @return Returns a file descriptor for the event, or -1 when it could not be opened.
+ */
+int32_t Counters::open_event(uint32_t type, uint64_t config)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = type;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    for (uint8_t exclude_kernel = 0; exclude_kernel <= 1; exclude_kernel++) {
+        attr.exclude_kernel = exclude_kernel;
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd >= 0) return static_cast<int32_t>(fd);
+    }
+    return -1;
+}
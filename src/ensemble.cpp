@@ -0,0 +1,524 @@
+/* 100-Prisoners-1-Switch-Problem
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for ensemble.h.                                                   |
+|===========================================================================================================|
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include "ensemble.h"
+#include "global.h"
+#include "parser.h"
+#include "records.h"
+#include "switch.h"
+#include "timing.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ENSEMBLE_X86
+#endif
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object.
+ *
+ * @param mode Engine to use; e_auto, or an engine the CPU doesn't support, picks the widest one it does.
+ * @param prisoners Number of prisoners in every challenge, from 1 to MAX_PRISONERS.
+ * @throws std::invalid_argument When the number of prisoners is out of range, or the mode is e_off.
+ */
+Ensemble::Ensemble(ensemble_mode mode, uint32_t prisoners) :
+    engine(mode != ensemble_mode::e_auto && Ensemble::supports(mode) ? mode :
+        Ensemble::supports(ensemble_mode::e_avx512) ? ensemble_mode::e_avx512 :
+        Ensemble::supports(ensemble_mode::e_avx2) ? ensemble_mode::e_avx2 : ensemble_mode::e_scalar),
+    lanes(this->engine == ensemble_mode::e_avx512 ? 16 : this->engine == ensemble_mode::e_avx2 ? 8 : 1),
+    number_of_prisoners(prisoners), target((prisoners - 1) * Global::SETTER_MAX_COUNT),
+    improper(Parser::get_strategy() == strategy::improper),
+    words(static_cast<size_t>(prisoners) * this->lanes, 0)
+{
+    if (mode == ensemble_mode::e_off) throw std::invalid_argument("Ensemble needs an engine");
+    if (prisoners == 0 || prisoners > Ensemble::MAX_PRISONERS)
+        throw std::invalid_argument("Ensemble needs from 1 to " + std::to_string(Ensemble::MAX_PRISONERS) +
+            " prisoners");
+}
+
+/**
+ * @brief SUB METHOD - Runs a number of challenges, recording each one's result.
+ *
+ * @details Challenges are run as many at a time as there are lanes. Each one's seconds are the wall time of
+ * the group it was run in, split evenly among the group, since lanes share the time they run in.
+ *
+ * @param first Number of the first challenge, which decides its random numbers along with the seed.
+ * @param count Number of challenges to run, numbered from first on.
+ * @param worker Worker running them, for the records.
+ * @param stats Summary to record every result in.
+ * @param last Where to put the last challenge's result, or nullptr.
+ */
+void Ensemble::run(uint64_t first, uint64_t count, uint32_t worker, TrialStats* stats, ChallengeResult* last)
+{
+    for (uint64_t done = 0; done < count; done += this->lanes) {
+        uint32_t used = static_cast<uint32_t>(std::min<uint64_t>(this->lanes, count - done));
+        Timing::begin(phase::ph_init);
+        std::fill(this->words.begin(), this->words.end(), 0);
+        for (uint32_t lane = 0; lane < this->lanes; lane++) this->seed(lane, first + done + lane);
+        Timing::end(phase::ph_init);
+
+        Timing::begin(phase::ph_contest);
+        auto start = std::chrono::high_resolution_clock::now();
+        switch (this->engine) {
+            case ensemble_mode::e_avx512:
+                this->run_avx512(used);
+                break;
+            case ensemble_mode::e_avx2:
+                this->run_avx2(used);
+                break;
+            default:
+                this->run_scalar(used);
+                break;
+        }
+        std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+        Timing::end(phase::ph_contest);
+
+        for (uint32_t lane = 0; lane < used; lane++) {
+            ChallengeResult result;
+            result.success = this->distinct[lane] == this->number_of_prisoners;
+            result.entries = this->entries[lane];
+            result.flips = this->flips[lane];
+            result.seconds = duration.count() / used;
+            result.coverage = this->coverage[lane];
+            result.started_on = this->started_on[lane];
+            stats->record(result);
+            Records::write(result, first + done + lane, worker);
+            if (last != nullptr) *last = result;
+        }
+    }
+}
+
+/**
+ * @brief GETTER - Interface for getting the engine in use.
+ *
+ * @return Returns e_avx512, e_avx2, or e_scalar.
+ */
+ensemble_mode Ensemble::get_engine() const
+{
+    return this->engine;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many challenges are run side by side.
+ *
+ * @return Returns 16, 8, or 1.
+ */
+uint32_t Ensemble::get_lanes() const
+{
+    return this->lanes;
+}
+
+/**
+ * @brief GETTER - Checks whether the CPU can run an engine.
+ *
+ * @param mode Engine to check.
+ * @return Returns true for the scalar engine and e_auto, and for a vector engine when the CPU has its
+ * instruction set; false for e_off.
+ */
+bool Ensemble::supports(ensemble_mode mode)
+{
+#ifdef ENSEMBLE_X86
+    __builtin_cpu_init();
+    if (mode == ensemble_mode::e_avx512) return __builtin_cpu_supports("avx512f");
+    if (mode == ensemble_mode::e_avx2) return __builtin_cpu_supports("avx2");
+#else
+    if (mode == ensemble_mode::e_avx512 || mode == ensemble_mode::e_avx2) return false;
+#endif
+    return mode != ensemble_mode::e_off;
+}
+
+/**
+ * @brief GETTER - Gets the name of an engine, as given to "--ensemble".
+ *
+ * @param mode Engine to name.
+ * @return Returns a string literal.
+ */
+const char* Ensemble::name(ensemble_mode mode)
+{
+    switch (mode) {
+        case ensemble_mode::e_auto:     return "on";
+        case ensemble_mode::e_avx512:   return "avx512";
+        case ensemble_mode::e_avx2:     return "avx2";
+        case ensemble_mode::e_scalar:   return "scalar";
+        default:                        return "off";
+    }
+}
+
+/**
+ * @brief HELPER - Draws the next random number of a lane, by xoshiro128**.
+ *
+ * @param lane Lane to draw for.
+ * @return Returns 32 random bits.
+ */
+uint32_t Ensemble::next(uint32_t lane)
+{
+    uint32_t* s[4] = {&this->rng[0][lane], &this->rng[1][lane], &this->rng[2][lane], &this->rng[3][lane]};
+    uint32_t x = *s[1] * 5;
+    uint32_t result = ((x << 7) | (x >> 25)) * 9;
+    uint32_t t = *s[1] << 9;
+    *s[2] ^= *s[0];
+    *s[3] ^= *s[1];
+    *s[1] ^= *s[2];
+    *s[0] ^= *s[3];
+    *s[2] ^= t;
+    *s[3] = (*s[3] << 11) | (*s[3] >> 21);
+    return result;
+}
+
+/**
+ * @brief INITIALIZER - Starts a challenge in a lane: seeds its random numbers and places the switch.
+ *
+ * @details The lane's generator is seeded by SplitMix64 from the run's seed and the challenge's number
+ * alone, so the same challenge always draws the same numbers, whatever lane or engine it runs in.
+ *
+ * @param lane Lane to start the challenge in.
+ * @param trial Number of the challenge.
+ */
+void Ensemble::seed(uint32_t lane, uint64_t trial)
+{
+    uint64_t z = (static_cast<uint64_t>(Parser::get_seed()) << 32) ^ trial;
+    for (uint32_t half = 0; half < 2; half++) {
+        z += 0x9E3779B97F4A7C15ULL;
+        uint64_t mixed = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+        mixed ^= mixed >> 31;
+        this->rng[2 * half][lane] = static_cast<uint32_t>(mixed);
+        this->rng[2 * half + 1][lane] = static_cast<uint32_t>(mixed >> 32);
+    }
+    if ((this->rng[0][lane] | this->rng[1][lane] | this->rng[2][lane] | this->rng[3][lane]) == 0)
+        this->rng[0][lane] = 1;     // the one state xoshiro can't leave
+
+    switch_state initial_state = Parser::get_initial_switch_state();
+    if (initial_state == switch_state::on) this->position[lane] = RoomSwitch::TOP;
+    else if (initial_state == switch_state::off) this->position[lane] = 0;
+    else this->position[lane] = static_cast<uint32_t>(
+        (static_cast<uint64_t>(this->next(lane)) * Global::POSITIONS) >> 32);
+    this->started_on[lane] = this->position[lane] > 0;
+    this->counted[lane] = 0;
+    this->flips[lane] = 0;
+    this->distinct[lane] = 0;
+    this->started_off[lane] = 0;
+    this->entries[lane] = 0;
+    this->coverage[lane] = 0;
+}
+
+/**
+ * @brief HELPER - Records that the challenge in a lane is over.
+ *
+ * @param lane Lane whose challenge is over.
+ * @param step Number of visits made in it, counting the last.
+ */
+void Ensemble::finish(uint32_t lane, uint64_t step)
+{
+    this->entries[lane] = step;
+}
+
+/**
+ * @brief SUB METHOD - Runs the challenges in the first lanes to the end, one after another.
+ *
+ * @details Every visit follows the prison's rules exactly: the last prisoner is the resetter, who counts
+ * every step the switch was turned up and turns it back to 0, while a setter turns it up as far as it goes
+ * until they have turned it up as many steps as it has positions. The vector engines make the very same
+ * visits in every lane at once.
+ *
+ * @param used Number of lanes with a challenge in them.
+ */
+void Ensemble::run_scalar(uint32_t used)
+{
+    const uint32_t n = this->number_of_prisoners;
+    const uint32_t m = Global::POSITIONS;
+    const uint32_t top = RoomSwitch::TOP;
+    const uint32_t slack = this->target > 0 ? top : 0;  // steps the resetter needn't count if it began off
+    for (uint32_t lane = 0; lane < used; lane++) {
+        uint32_t pos = this->position[lane];
+        uint32_t count = this->counted[lane];
+        uint32_t flip = this->flips[lane];
+        uint32_t seen = this->distinct[lane];
+        uint32_t began_off = this->started_off[lane];
+        uint64_t step = 0;
+        bool over = false;
+        while (!over) {
+            uint32_t idx = static_cast<uint32_t>((static_cast<uint64_t>(this->next(lane)) * n) >> 32);
+            uint32_t& word = this->words[static_cast<size_t>(idx) * this->lanes + lane];
+            uint32_t entered = word & 0xFFFF;
+            uint32_t turned = word >> 16;
+            step++;
+            if (entered == 0 && ++seen == n) this->coverage[lane] = step;
+            if (idx == n - 1) {
+                if (entered == 0 && pos == 0) began_off = UINT32_MAX;
+                if (pos > 0) {
+                    count += pos;
+                    pos = 0;
+                    flip++;
+                }
+                over = count >= this->target - (began_off & slack);
+            } else {
+                if (turned < m && pos < top) {
+                    uint32_t to = std::min(top, pos + m - turned);
+                    turned += to - pos;
+                    pos = to;
+                    flip++;
+                }
+                over = this->improper && entered >= m && turned >= m;
+            }
+            word = std::min(entered + 1, m + 1) | (turned << 16);  // visits only need counting past m
+        }
+        this->position[lane] = pos;
+        this->counted[lane] = count;
+        this->flips[lane] = flip;
+        this->distinct[lane] = seen;
+        this->started_off[lane] = began_off;
+        this->finish(lane, step);
+    }
+}
+
+#ifdef ENSEMBLE_X86
+
+/**
+ * @brief SUB METHOD - Runs the challenges in the first lanes to the end, 8 side by side, with AVX2.
+ *
+ * @details Makes exactly the visits run_scalar() would, in every lane at once; see there. AVX2 can gather
+ * but not scatter, so the words are written back one lane at a time, which is safe since no two lanes ever
+ * share a word.
+ *
+ * @param used Number of lanes with a challenge in them.
+ */
+[[gnu::target("avx2")]]
+void Ensemble::run_avx2(uint32_t used)
+{
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i five = _mm256_set1_epi32(5);
+    const __m256i nine = _mm256_set1_epi32(9);
+    const __m256i low = _mm256_set1_epi32(0xFFFF);
+    const __m256i n = _mm256_set1_epi32(static_cast<int32_t>(this->number_of_prisoners));
+    const __m256i resetter = _mm256_set1_epi32(static_cast<int32_t>(this->number_of_prisoners - 1));
+    const __m256i m = _mm256_set1_epi32(Global::POSITIONS);
+    const __m256i top = _mm256_set1_epi32(RoomSwitch::TOP);
+    const __m256i full = _mm256_set1_epi32(Global::POSITIONS + 1);
+    const __m256i goal = _mm256_set1_epi32(static_cast<int32_t>(this->target));
+    const __m256i slack = _mm256_set1_epi32(this->target > 0 ? RoomSwitch::TOP : 0);
+    const __m256i declaring = _mm256_set1_epi32(this->improper ? -1 : 0);
+    int32_t* base = reinterpret_cast<int32_t*>(this->words.data());
+    alignas(32) int32_t addresses[8];
+    alignas(32) int32_t values[8];
+
+    __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->rng[0]));
+    __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->rng[1]));
+    __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->rng[2]));
+    __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->rng[3]));
+    __m256i pos = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->position));
+    __m256i count = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->counted));
+    __m256i flip = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->flips));
+    __m256i seen = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->distinct));
+    __m256i began_off = _mm256_load_si256(reinterpret_cast<const __m256i*>(this->started_off));
+    __m256i active = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int32_t>(used)), lane);
+    uint64_t step = 0;
+    while (true) {
+        // next random number in every lane, by xoshiro128**
+        __m256i x = _mm256_mullo_epi32(s1, five);
+        x = _mm256_or_si256(_mm256_slli_epi32(x, 7), _mm256_srli_epi32(x, 25));
+        __m256i r = _mm256_mullo_epi32(x, nine);
+        __m256i t = _mm256_slli_epi32(s1, 9);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+
+        // the prisoner picked in every lane, (r * n) >> 32, which takes a multiply for odd and even lanes
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(r, n), 32);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(r, 32), n);
+        __m256i idx = _mm256_blend_epi32(even, odd, 0xAA);
+        __m256i address = _mm256_add_epi32(_mm256_slli_epi32(idx, 3), lane);
+        __m256i word = _mm256_i32gather_epi32(base, address, 4);
+        __m256i entered = _mm256_and_si256(word, low);
+        __m256i turned = _mm256_srli_epi32(word, 16);
+        step++;
+
+        // their visit
+        __m256i first = _mm256_and_si256(active, _mm256_cmpeq_epi32(entered, zero));
+        seen = _mm256_sub_epi32(seen, first);
+        __m256i covered = _mm256_and_si256(first, _mm256_cmpeq_epi32(seen, n));
+        __m256i is_resetter = _mm256_cmpeq_epi32(idx, resetter);
+        __m256i off = _mm256_cmpeq_epi32(pos, zero);
+        __m256i resets = _mm256_and_si256(active, is_resetter);
+        began_off = _mm256_or_si256(began_off, _mm256_and_si256(_mm256_and_si256(first, is_resetter), off));
+        __m256i collects = _mm256_andnot_si256(off, resets);
+        count = _mm256_add_epi32(count, _mm256_and_si256(collects, pos));
+        __m256i sets = _mm256_andnot_si256(is_resetter, active);
+        __m256i can = _mm256_and_si256(sets,
+            _mm256_and_si256(_mm256_cmpgt_epi32(m, turned), _mm256_cmpgt_epi32(top, pos)));
+        __m256i to = _mm256_min_epu32(top, _mm256_sub_epi32(_mm256_add_epi32(pos, m), turned));
+        turned = _mm256_add_epi32(turned, _mm256_and_si256(can, _mm256_sub_epi32(to, pos)));
+        flip = _mm256_sub_epi32(flip, _mm256_or_si256(collects, can));
+        pos = _mm256_blendv_epi8(_mm256_andnot_si256(collects, pos), to, can);
+        entered = _mm256_min_epu32(_mm256_add_epi32(entered, one), full);
+
+        // whether it ended the challenge
+        __m256i needed = _mm256_sub_epi32(goal, _mm256_and_si256(began_off, slack));
+        __m256i all_counted = _mm256_cmpeq_epi32(_mm256_max_epu32(count, needed), count);
+        __m256i declared = _mm256_and_si256(declaring,
+            _mm256_and_si256(_mm256_cmpeq_epi32(entered, full), _mm256_cmpeq_epi32(turned, m)));
+        __m256i over = _mm256_or_si256(_mm256_and_si256(resets, all_counted),
+            _mm256_and_si256(sets, declared));
+
+        word = _mm256_blendv_epi8(word, _mm256_or_si256(entered, _mm256_slli_epi32(turned, 16)), active);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(addresses), address);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values), word);
+        for (uint32_t l = 0; l < 8; l++) base[addresses[l]] = values[l];
+
+        // rarely, a lane has just been covered or is over
+        __m256i events = _mm256_or_si256(covered, over);
+        if (_mm256_testz_si256(events, events)) continue;
+        _mm256_store_si256(reinterpret_cast<__m256i*>(this->flips), flip);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(this->distinct), seen);
+        uint32_t covered_lanes = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(covered)));
+        uint32_t over_lanes = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(over)));
+        for (uint32_t l = 0; l < 8; l++) {
+            if ((covered_lanes >> l) & 1) this->coverage[l] = step;
+            if ((over_lanes >> l) & 1) this->finish(l, step);
+        }
+        active = _mm256_andnot_si256(over, active);
+        if (_mm256_testz_si256(active, active)) break;
+    }
+}
+
+/**
+ * @brief SUB METHOD - Runs the challenges in the first lanes to the end, 16 side by side, with AVX-512.
+ *
+ * @details Makes exactly the visits run_scalar() would, in every lane at once; see there. Lanes whose
+ * challenge is over are left out of every update by the active mask.
+ *
+ * @param used Number of lanes with a challenge in them.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"   // the intrinsics' own placeholder vectors trip these,
+#pragma GCC diagnostic ignored "-Wsign-conversion" // as do the gather and scatter macros in debug builds
+[[gnu::target("avx512f")]]
+void Ensemble::run_avx512(uint32_t used)
+{
+    const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i five = _mm512_set1_epi32(5);
+    const __m512i nine = _mm512_set1_epi32(9);
+    const __m512i low = _mm512_set1_epi32(0xFFFF);
+    const __m512i n = _mm512_set1_epi32(static_cast<int32_t>(this->number_of_prisoners));
+    const __m512i resetter = _mm512_set1_epi32(static_cast<int32_t>(this->number_of_prisoners - 1));
+    const __m512i m = _mm512_set1_epi32(Global::POSITIONS);
+    const __m512i top = _mm512_set1_epi32(RoomSwitch::TOP);
+    const __m512i full = _mm512_set1_epi32(Global::POSITIONS + 1);
+    const __m512i goal = _mm512_set1_epi32(static_cast<int32_t>(this->target));
+    const __m512i slack = _mm512_set1_epi32(this->target > 0 ? RoomSwitch::TOP : 0);
+    const __mmask16 declaring = this->improper ? 0xFFFF : 0;
+    int32_t* base = reinterpret_cast<int32_t*>(this->words.data());
+
+    __m512i s0 = _mm512_load_si512(this->rng[0]);
+    __m512i s1 = _mm512_load_si512(this->rng[1]);
+    __m512i s2 = _mm512_load_si512(this->rng[2]);
+    __m512i s3 = _mm512_load_si512(this->rng[3]);
+    __m512i pos = _mm512_load_si512(this->position);
+    __m512i count = _mm512_load_si512(this->counted);
+    __m512i flip = _mm512_load_si512(this->flips);
+    __m512i seen = _mm512_load_si512(this->distinct);
+    __m512i off_words = _mm512_load_si512(this->started_off);
+    __mmask16 began_off = _mm512_test_epi32_mask(off_words, off_words);
+    __mmask16 active = static_cast<__mmask16>((1u << used) - 1);
+    uint64_t step = 0;
+    while (true) {
+        // next random number in every lane, by xoshiro128**
+        __m512i r = _mm512_mullo_epi32(_mm512_rol_epi32(_mm512_mullo_epi32(s1, five), 7), nine);
+        __m512i t = _mm512_slli_epi32(s1, 9);
+        s2 = _mm512_xor_si512(s2, s0);
+        s3 = _mm512_xor_si512(s3, s1);
+        s1 = _mm512_xor_si512(s1, s2);
+        s0 = _mm512_xor_si512(s0, s3);
+        s2 = _mm512_xor_si512(s2, t);
+        s3 = _mm512_rol_epi32(s3, 11);
+
+        // the prisoner picked in every lane, (r * n) >> 32, which takes a multiply for odd and even lanes
+        __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(r, n), 32);
+        __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(r, 32), n);
+        __m512i idx = _mm512_mask_blend_epi32(0xAAAA, even, odd);
+        __m512i address = _mm512_add_epi32(_mm512_slli_epi32(idx, 4), lane);
+        __m512i word = _mm512_i32gather_epi32(address, base, 4);
+        __m512i entered = _mm512_and_si512(word, low);
+        __m512i turned = _mm512_srli_epi32(word, 16);
+        step++;
+
+        // their visit
+        __mmask16 first = _mm512_mask_cmpeq_epi32_mask(active, entered, zero);
+        seen = _mm512_mask_add_epi32(seen, first, seen, one);
+        __mmask16 covered = _mm512_mask_cmpeq_epi32_mask(first, seen, n);
+        __mmask16 is_resetter = _mm512_cmpeq_epi32_mask(idx, resetter);
+        __mmask16 off = _mm512_cmpeq_epi32_mask(pos, zero);
+        __mmask16 resets = _mm512_kand(active, is_resetter);
+        began_off = _mm512_kor(began_off, _mm512_kand(_mm512_kand(first, is_resetter), off));
+        __mmask16 collects = _mm512_kandn(off, resets);
+        count = _mm512_mask_add_epi32(count, collects, count, pos);
+        __mmask16 sets = _mm512_kandn(is_resetter, active);
+        __mmask16 can = _mm512_kand(sets, _mm512_kand(_mm512_cmplt_epu32_mask(turned, m),
+            _mm512_cmplt_epu32_mask(pos, top)));
+        __m512i to = _mm512_min_epu32(top, _mm512_sub_epi32(_mm512_add_epi32(pos, m), turned));
+        turned = _mm512_mask_add_epi32(turned, can, turned, _mm512_sub_epi32(to, pos));
+        flip = _mm512_mask_add_epi32(flip, _mm512_kor(collects, can), flip, one);
+        pos = _mm512_mask_mov_epi32(_mm512_maskz_mov_epi32(_mm512_knot(collects), pos), can, to);
+        entered = _mm512_min_epu32(_mm512_add_epi32(entered, one), full);
+
+        // whether it ended the challenge
+        __m512i needed = _mm512_mask_sub_epi32(goal, began_off, goal, slack);
+        __mmask16 all_counted = _mm512_cmpge_epu32_mask(count, needed);
+        __mmask16 declared = _mm512_kand(declaring, _mm512_kand(_mm512_cmpeq_epi32_mask(entered, full),
+            _mm512_cmpge_epu32_mask(turned, m)));
+        __mmask16 over = _mm512_kor(_mm512_kand(resets, all_counted), _mm512_kand(sets, declared));
+
+        _mm512_mask_i32scatter_epi32(base, active, address,
+            _mm512_or_si512(entered, _mm512_slli_epi32(turned, 16)), 4);
+
+        // rarely, a lane has just been covered or is over
+        if (_mm512_kortestz(covered, over)) continue;
+        _mm512_store_si512(this->flips, flip);
+        _mm512_store_si512(this->distinct, seen);
+        for (uint32_t l = 0; l < 16; l++) {
+            if ((covered >> l) & 1) this->coverage[l] = step;
+            if ((over >> l) & 1) this->finish(l, step);
+        }
+        active = _mm512_kandn(over, active);
+        if (active == 0) break;
+    }
+}
+#pragma GCC diagnostic pop
+
+#else
+
+/**
+ * @brief SUB METHOD - Stands in for the AVX2 engine on other CPUs; never called, see supports().
+ *
+ * @param used Number of lanes with a challenge in them.
+ */
+void Ensemble::run_avx2(uint32_t used)
+{
+    this->run_scalar(used);
+}
+
+/**
+ * @brief SUB METHOD - Stands in for the AVX-512 engine on other CPUs; never called, see supports().
+ *
+ * @param used Number of lanes with a challenge in them.
+ */
+void Ensemble::run_avx512(uint32_t used)
+{
+    this->run_scalar(used);
+}
+
+#endif
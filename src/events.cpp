@@ -0,0 +1,128 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for events.h.                                                     |
+|===========================================================================================================|
+*/
+
+#include <stdexcept>
+#include "events.h"
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object.
+ *
+ * @param m Shape of the distribution of the time between visits.
+ * @param mean_period Mean number of days between two visits by the same prisoner; must be positive.
+ * @throws std::invalid_argument When the period is not positive.
+ */
+ArrivalClock::ArrivalClock(arrival_mode m, double mean_period) : mode(m), period(mean_period),
+    exponential(mean_period > 0.0 ? 1.0 / mean_period : 1.0), uniform(0.0, 2.0 * mean_period)
+{
+    if (!(mean_period > 0.0)) throw std::invalid_argument("ArrivalClock needs a positive period");
+}
+
+/**
+ * @brief GETTER - Draws the time of a prisoner's first visit, counted from the start of the challenge.
+ *
+ * @details For fixed arrivals, every prisoner gets a random phase within one period, so they don't all
+ * arrive together. The other modes just draw a regular gap, as if the clock had been running already.
+ *
+ * @param mt Mersenne Twister to draw from.
+ * @return Returns a non-negative number of days.
+ */
+double ArrivalClock::first(std::mt19937& mt)
+{
+    if (this->mode == arrival_mode::a_fixed) return this->uniform(mt) / 2.0;
+    return this->next(mt);
+}
+
+/**
+ * @brief GETTER - Draws the time between a prisoner's visit and their next one.
+ *
+ * @param mt Mersenne Twister to draw from.
+ * @return Returns a non-negative number of days with the clock's mean.
+ */
+double ArrivalClock::next(std::mt19937& mt)
+{
+    switch (this->mode) {
+        case arrival_mode::a_exp:
+            return this->exponential(mt);
+        case arrival_mode::a_uniform:
+            return this->uniform(mt);
+        case arrival_mode::a_fixed:
+            return this->period;
+        default:
+            throw std::logic_error("ArrivalClock has an invalid arrival mode");
+    }
+}
+
+/**
+ * @brief CONSTRUCTOR - Builds the heap from every prisoner's first visit, in linear time.
+ *
+ * @param events One pending visit per prisoner, in any order.
+ * @throws std::invalid_argument When there are no events.
+ */
+EventQueue::EventQueue(std::vector<Event>&& events) : heap(std::move(events))
+{
+    size_t n = this->heap.size();
+    if (n == 0) throw std::invalid_argument("EventQueue needs at least one event");
+    if (n > 1) for (size_t at = (n - 2) / EventQueue::ARITY + 1; at-- > 0;) this->sift_down(at);
+}
+
+/**
+ * @brief HELPER - Moves the event at the given position down until none of its children are sooner.
+ *
+ * @param at Position in the heap to start from.
+ */
+void EventQueue::sift_down(size_t at)
+{
+    size_t n = this->heap.size();
+    Event moving = this->heap[at];
+    while (true) {
+        size_t first_child = at * EventQueue::ARITY + 1;
+        if (first_child >= n) break;
+        size_t last_child = first_child + EventQueue::ARITY < n ? first_child + EventQueue::ARITY : n;
+        size_t soonest = first_child;
+        for (size_t child = first_child + 1; child < last_child; child++)
+            if (this->heap[child].time < this->heap[soonest].time) soonest = child;
+        if (!(this->heap[soonest].time < moving.time)) break;
+        this->heap[at] = this->heap[soonest];
+        at = soonest;
+    }
+    this->heap[at] = moving;
+}
+
+/**
+ * @brief GETTER - Interface for getting the soonest pending visit.
+ *
+ * @return Returns a reference to the event at the front of the heap.
+ */
+const EventQueue::Event& EventQueue::top() const
+{
+    return this->heap.front();
+}
+
+/**
+ * @brief SETTER - Moves the soonest pending visit to a later time, once that prisoner has had their visit.
+ *
+ * @details This is a pop followed by a push of the same prisoner, done as a single sift down, since times
+ * only ever move forward and every prisoner always has exactly one pending visit.
+ *
+ * @param time Virtual time of that prisoner's next visit; must not be sooner than their last one.
+ */
+void EventQueue::reschedule_top(double time)
+{
+    this->heap.front().time = time;
+    this->sift_down(0);
+}
+
+/**
+ * @brief GETTER - Interface for getting the number of pending visits.
+ *
+ * @return Returns the number of events in the queue, which is the number of prisoners.
+ */
+size_t EventQueue::size() const
+{
+    return this->heap.size();
+}
@@ -0,0 +1,192 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for handoff.h.                                                    |
+|===========================================================================================================|
+*/
+
+#include "handoff.h"
+
+
+/*=============================================== WaitList ================================================*/
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object, with nobody waiting.
+ *
+ * @param number_of_prisoners Number of prisoners who may ever wait for the room.
+ * @param p Policy for choosing the next prisoner among those waiting.
+ * @param seed Seed for the random policy, so that its choices are reproducible.
+ */
+WaitList::WaitList(uint32_t number_of_prisoners, handoff_policy p, uint32_t seed) : policy(p),
+    last_visit(number_of_prisoners + 1, 0), mt(seed)
+{
+    if (p == handoff_policy::h_random) this->waiting.reserve(number_of_prisoners);
+}
+
+/**
+ * @brief HELPER - Adds a prisoner to the structure used by the current policy.
+ *
+ * @param index Unique index of the prisoner who is starting to wait.
+ */
+void WaitList::push(uint32_t index)
+{
+    switch (this->policy) {
+        case handoff_policy::h_rr:
+            this->waiting_rr.insert(index);
+            break;
+        case handoff_policy::h_lrv:
+            this->waiting_lrv.insert(std::make_pair(this->last_visit.at(index), index));
+            break;
+        case handoff_policy::h_random:
+        default:
+            this->waiting.push_back(index);
+            break;
+    }
+}
+
+/**
+ * @brief HELPER - Removes and returns the next prisoner according to the policy; someone must be waiting.
+ *
+ * @details Every policy takes at most logarithmic time in the number of waiting prisoners; the random
+ * policy takes constant time by swapping the chosen prisoner with the last one before removing it.
+ *
+ * @return Returns the unique index of the chosen prisoner.
+ */
+uint32_t WaitList::pop()
+{
+    uint32_t next;
+    switch (this->policy) {
+        case handoff_policy::h_rr: {
+            auto it = this->waiting_rr.upper_bound(this->last_granted);
+            if (it == this->waiting_rr.end()) it = this->waiting_rr.begin();
+            next = *it;
+            this->waiting_rr.erase(it);
+            break;
+        }
+        case handoff_policy::h_lrv:
+            next = this->waiting_lrv.begin()->second;
+            this->waiting_lrv.erase(this->waiting_lrv.begin());
+            break;
+        case handoff_policy::h_random:
+        default: {
+            std::uniform_int_distribution<size_t> dist(0, this->waiting.size() - 1);
+            size_t chosen = dist(this->mt);
+            next = this->waiting.at(chosen);
+            this->waiting.at(chosen) = this->waiting.back();
+            this->waiting.pop_back();
+            break;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief GETTER - Interface for getting whether anyone is waiting.
+ *
+ * @return Returns true when nobody is waiting, false otherwise.
+ */
+bool WaitList::empty() const
+{
+    return this->waiting.empty() && this->waiting_rr.empty() && this->waiting_lrv.empty();
+}
+
+/**
+ * @brief SETTER - Records who was let in last, which the rr policy goes on from.
+ *
+ * @param index Unique index of the prisoner let in, whether they waited or walked in.
+ */
+void WaitList::grant(uint32_t index)
+{
+    this->last_granted = index;
+}
+
+/**
+ * @brief SETTER - Records that a prisoner left the room, which the lrv policy goes by.
+ *
+ * @param index Unique index of the prisoner leaving the room.
+ */
+void WaitList::leave(uint32_t index)
+{
+    this->last_visit.at(index) = ++this->clock;
+}
+
+
+/*=============================================== Handoff =================================================*/
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object.
+ *
+ * @param number_of_prisoners Number of prisoners who may ever wait for the room.
+ * @param p Policy for choosing the next prisoner among those waiting.
+ * @param seed Seed for the random policy, so that its choices are reproducible.
+ */
+Handoff::Handoff(uint32_t number_of_prisoners, handoff_policy p, uint32_t seed) :
+    slots(number_of_prisoners + 1), waiting(number_of_prisoners, p, seed) {}
+
+/**
+ * @brief SEMAPHORE - Blocks the calling prisoner thread until it holds the room.
+ *
+ * @details If the room is free, the caller takes it immediately. Otherwise the caller parks on its own
+ * condition variable until a departing prisoner chooses it in release().
+ *
+ * @param index Unique index of the calling prisoner.
+ */
+void Handoff::acquire(uint32_t index)
+{
+    std::unique_lock<std::mutex> lock(this->m);
+    if (!this->occupied) {
+        this->occupied = true;
+        this->waiting.grant(index);
+        this->walk_ins++;
+        return;
+    }
+    Slot& slot = this->slots.at(index);
+    slot.granted = false;
+    this->waiting.push(index);
+    slot.cv.wait(lock, [&slot]() { return slot.granted; });
+}
+
+/**
+ * @brief SEMAPHORE - Hands the room to exactly one waiting prisoner, or leaves it free if nobody waits.
+ *
+ * @param index Unique index of the prisoner leaving the room.
+ */
+void Handoff::release(uint32_t index)
+{
+    std::unique_lock<std::mutex> lock(this->m);
+    this->waiting.leave(index);
+    if (this->waiting.empty()) {
+        this->occupied = false;
+        return;
+    }
+    uint32_t next = this->waiting.pop();
+    this->waiting.grant(next);
+    this->handoffs++;
+    Slot& slot = this->slots.at(next);
+    slot.granted = true;
+    lock.unlock();
+    slot.cv.notify_one();
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times the room was handed straight to a waiting prisoner.
+ *
+ * @return Returns an integer greater than or equal to 0.
+ */
+uint64_t Handoff::get_handoff_count()
+{
+    std::lock_guard<std::mutex> guard(this->m);
+    return this->handoffs;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times a prisoner found the room free and walked in.
+ *
+ * @return Returns an integer greater than or equal to 0.
+ */
+uint64_t Handoff::get_walk_in_count()
+{
+    std::lock_guard<std::mutex> guard(this->m);
+    return this->walk_ins;
+}
@@ -0,0 +1,66 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for importance.h.                                                 |
+|===========================================================================================================|
+*/
+
+#include <cmath>
+#include <stdexcept>
+#include "importance.h"
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object, with nobody having been in yet.
+ *
+ * @param number_of_prisoners Number of prisoners to pick from, at positions 0 to number_of_prisoners - 1.
+ * @param b Bias toward prisoners who have been in; 1 picks uniformly, like the pseudo warden.
+ * @throws std::invalid_argument When there are no prisoners or the bias is below 1.
+ */
+BiasedPicker::BiasedPicker(uint32_t number_of_prisoners, double b) : n(number_of_prisoners), bias(b),
+    order(number_of_prisoners), unit(0.0, 1.0)
+{
+    if (number_of_prisoners == 0) throw std::invalid_argument("BiasedPicker needs at least one prisoner");
+    if (!(b >= 1.0)) throw std::invalid_argument("BiasedPicker needs a bias of at least 1");
+    for (uint32_t i = 0; i < number_of_prisoners; i++) this->order[i] = i;
+}
+
+/**
+ * @brief GETTER - Picks the next prisoner to go in, and multiplies the weight by the pick's likelihood ratio.
+ *
+ * @details With v prisoners visited, the biased total is W = v * b + (n - v). A visited prisoner is picked
+ * with probability b / W and an unvisited one with 1 / W, against 1 / n under the real warden, so the
+ * ratio is W / (n * b) or W / n. An unvisited prisoner who is picked goes in right away, so they are moved
+ * to the visited part of the order.
+ *
+ * @param mt Mersenne Twister to draw from.
+ * @return Returns the position of the prisoner who goes in next.
+ */
+uint32_t BiasedPicker::pick(std::mt19937& mt)
+{
+    double v = static_cast<double>(this->visited);
+    double total = v * this->bias + static_cast<double>(this->n - this->visited);
+    if (this->unit(mt) * total < v * this->bias) {
+        std::uniform_int_distribution<uint32_t> among(0, this->visited - 1);
+        this->log_weight += std::log(total / (static_cast<double>(this->n) * this->bias));
+        return this->order[among(mt)];
+    }
+    std::uniform_int_distribution<uint32_t> among(this->visited, this->n - 1);
+    uint32_t slot = among(mt);
+    uint32_t chosen = this->order[slot];
+    this->order[slot] = this->order[this->visited];
+    this->order[this->visited] = chosen;
+    this->visited++;
+    this->log_weight += std::log(total / static_cast<double>(this->n));
+    return chosen;
+}
+
+/**
+ * @brief GETTER - Interface for getting the likelihood ratio of the whole path of picks so far.
+ *
+ * @return Returns how much more likely the path is under the real warden than under the biased one.
+ */
+double BiasedPicker::get_weight() const
+{
+    return std::exp(this->log_weight);
+}
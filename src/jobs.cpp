@@ -0,0 +1,249 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for jobs.h.                                                       |
+|===========================================================================================================|
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include "jobs.h"
+#include "parser.h"
+#include "records.h"
+#include "timing.h"
+
+/**
+ * @brief MAIN METHOD - Runs every job of the jobs file, and writes a line about each of them, in order.
+ *
+ * @details The lines are written in the configuration's format, to its output file or to stdout. Notes
+ * about the lines of the jobs file are printed unless the configuration is silent. A job whose warden runs
+ * the prisoners on threads or processes of their own waits until no other job is running, and runs alone.
+ *
+ * @param config Configuration every job starts from, as given, before Parser::check() turned anything off;
+ * its jobs path names the file. Lines without a seed of their own use its seed, or one picked at random.
+ * @return Returns true if the prisoners went free in every trial of every job, false otherwise.
+ * @throws std::runtime_error When the jobs file or the output file can't be opened, or when a job can't be
+ * run as asked, in which case the jobs above it have been written and the rest are dropped.
+ */
+bool Jobs::run(const Config& config)
+{
+    Config settled = config;
+    Parser::check(settled, false);
+    bool notes = settled.output != out_mode::silent;
+    Config base = config;
+    base.seed = settled.seed;       // each line without a seed of its own gets one derived from it
+    base.seed_provided = false;
+
+    Timing::begin(phase::ph_parse);
+    std::vector<Job> jobs = Jobs::load(base, settled.jobs_path, notes);
+    Timing::end(phase::ph_parse);
+
+    uint32_t workers = static_cast<uint32_t>(std::clamp<size_t>(jobs.size(), 1,
+        static_cast<size_t>(std::max(settled.workers, 1))));
+
+    std::FILE* file = stdout;
+    if (settled.output_path.empty()) std::cout.flush();
+    else {
+        file = std::fopen(settled.output_path.c_str(), "w");
+        if (file == nullptr) throw std::runtime_error("Could not open output file " + settled.output_path);
+    }
+    std::string buffer;                     // lines not yet handed to the OS
+    buffer.reserve(Jobs::BUFFER_SIZE + 1024);
+    if (settled.format == out_format::f_csv)
+        buffer += "line,seed,prisoners,rooms,warden,strategy,initial_switch,trials,successes,entries_mean,"
+            "entries_min,entries_max,seconds_mean\n";
+
+    std::atomic<size_t> claimed = 0;        // jobs handed out so far
+    std::atomic<bool> stop = false;         // set once a job fails
+    std::shared_mutex alone;                // a job with a threaded warden holds it alone
+    std::mutex done_mutex;                  // protects everything below
+    std::vector<Results> results(jobs.size());
+    std::vector<bool> done(jobs.size(), false);
+    size_t written = 0;                     // jobs whose line is in the buffer
+    bool success = true;
+    std::exception_ptr error;
+    Timing::Clocks* clocks = Timing::current();
+
+    auto work = [&]() {
+        Timing::adopt(clocks);      // every job's times add up in the clocks of the thread that started them
+        while (!stop.load(std::memory_order_relaxed)) {
+            size_t i = claimed.fetch_add(1, std::memory_order_relaxed);
+            if (i >= jobs.size()) break;
+            Results result;
+            try {
+                if (Jobs::is_threaded(jobs[i].config.warden_type)) {
+                    std::unique_lock<std::shared_mutex> lock(alone);
+                    result = Simulator::run(jobs[i].config);
+                } else {
+                    std::shared_lock<std::shared_mutex> lock(alone);
+                    result = Simulator::run(jobs[i].config);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(done_mutex);
+                if (!error) error = std::current_exception();
+                stop.store(true, std::memory_order_relaxed);
+                break;
+            }
+
+            std::lock_guard<std::mutex> guard(done_mutex);
+            results[i] = std::move(result);
+            done[i] = true;
+            for (; written < jobs.size() && done[written]; written++) {
+                Jobs::describe(&buffer, settled.format, jobs[written], results[written]);
+                success = success && results[written].success;
+                results[written] = Results();   // nothing more is needed from it
+            }
+            if (buffer.size() >= Jobs::BUFFER_SIZE) {
+                std::fwrite(buffer.data(), 1, buffer.size(), file);
+                buffer.clear();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    try {
+        for (uint32_t worker = 1; worker < workers; worker++) threads.push_back(std::thread(work));
+    } catch (const std::system_error&) {}   // the workers that did start share the jobs between them
+    work();
+    for (std::thread& thread : threads) thread.join();
+
+    std::fwrite(buffer.data(), 1, buffer.size(), file);
+    if (file == stdout) std::fflush(stdout);
+    else std::fclose(file);
+    if (error) std::rethrow_exception(error);
+    return success;
+}
+
+/**
+ * @brief HELPER - Reads and parses every line of the jobs file.
+ *
+ * @details The settings that belong to the whole process, or that would print, are turned off for every job,
+ * and each job's configuration is settled the way Simulator::run() would, quietly. A line that gives no
+ * seed gets one of its own from line_seed(), so that identical lines are independent runs.
+ *
+ * @param base Configuration every line starts from, holding the seed lines without one are derived from.
+ * @param path Path of the jobs file.
+ * @param notes Whether to print what the parser notes about each line, along with where the line is.
+ * @return Returns the jobs, in the order of the file.
+ * @throws std::runtime_error When the jobs file can't be opened.
+ */
+std::vector<Jobs::Job> Jobs::load(const Config& base, const std::string& path, bool notes)
+{
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Could not open jobs file " + path);
+
+    std::vector<Job> jobs;
+    std::string text;
+    for (uint64_t line = 1; std::getline(in, text); line++) {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos || text.at(first) == '#') continue;
+
+        std::ostringstream said;    // the parser's notes, held back to say which line they are about
+        std::streambuf* out = std::cout.rdbuf(said.rdbuf());
+        Config config = Parser::parse_line(text, base);
+        std::cout.rdbuf(out);
+        if (notes) {
+            std::istringstream note(said.str());
+            std::string note_text;
+            while (std::getline(note, note_text)) std::cout << path << ":" << line << ": " << note_text <<
+                std::endl;
+        }
+
+        config.debug = debug_mode::d_off;
+        config.verbose = verb_mode::v_off;
+        config.output = out_mode::silent;
+        config.format = out_format::f_text;
+        config.output_path = "";
+        config.counters = false;
+        config.progress_ms = 0;
+        config.trace_path = "";
+        config.workers = 1;         // the jobs already run side by side
+        config.jobs_path = "";
+        if (!config.seed_provided) {
+            config.seed = Jobs::line_seed(base.seed, line);
+            config.seed_provided = true;
+        }
+        Parser::check(config, false);
+        jobs.push_back({line, config});
+    }
+    return jobs;
+}
+
+/**
+ * @brief HELPER - Adds the line describing what one job came to.
+ *
+ * @param out Where to add the line.
+ * @param format Format to write it in.
+ * @param job Job that was run.
+ * @param results What it came to.
+ */
+void Jobs::describe(std::string* out, out_format format, const Job& job, const Results& results)
+{
+    const Config& c = job.config;
+    const Welford& entries = results.stats.get_entries().get_moments();
+    double seconds = results.stats.get_seconds().get_moments().get_mean();
+    const char* w = Records::warden_name(c.warden_type);
+    const char* strat = c.strategy_type == strategy::proper ? "proper" : "improper";
+    const char* initial = c.initial_state == switch_state::on ? "on" :
+        (c.initial_state == switch_state::off ? "off" : "unknown");
+    uint32_t rooms = static_cast<uint32_t>(c.rooms);
+
+    char line[768];
+    int32_t len = 0;
+    if (format == out_format::f_json) len = std::snprintf(line, sizeof(line), "{\"line\":%" PRIu64 ","
+        "\"seed\":%" PRIu32 ",\"prisoners\":%" PRIu32 ",\"rooms\":%" PRIu32 ",\"warden\":\"%s\","
+        "\"strategy\":\"%s\",\"initial_switch\":\"%s\",\"trials\":%" PRIu64 ",\"successes\":%" PRIu64 ","
+        "\"entries_mean\":%.9g,\"entries_min\":%.9g,\"entries_max\":%.9g,\"seconds_mean\":%.9g}\n", job.line,
+        c.seed, c.prisoners, rooms, w, strat, initial, results.trials, results.successes, entries.get_mean(),
+        entries.get_min(), entries.get_max(), seconds);
+    else if (format == out_format::f_csv) len = std::snprintf(line, sizeof(line), "%" PRIu64 ",%" PRIu32
+        ",%" PRIu32 ",%" PRIu32 ",%s,%s,%s,%" PRIu64 ",%" PRIu64 ",%.9g,%.9g,%.9g,%.9g\n", job.line, c.seed,
+        c.prisoners, rooms, w, strat, initial, results.trials, results.successes, entries.get_mean(),
+        entries.get_min(), entries.get_max(), seconds);
+    else len = std::snprintf(line, sizeof(line), "Line %" PRIu64 " (%" PRIu32 " prisoners, %s warden, %s "
+        "strategy, switch %s, seed %" PRIu32 "): free in %" PRIu64 " of %" PRIu64 " trials, %.9g entries on "
+        "average (%.9g to %.9g), %.9g seconds on average\n", job.line, c.prisoners, w, strat, initial, c.seed,
+        results.successes, results.trials, entries.get_mean(), entries.get_min(), entries.get_max(), seconds);
+    if (len > 0) out->append(line, std::min(static_cast<size_t>(len), sizeof(line) - 1));
+}
+
+/**
+ * @brief HELPER - Derives the seed of a line of the jobs file that gives none of its own.
+ *
+ * @details The seed and the line number are mixed by SplitMix64, the same way the ensemble seeds its lanes,
+ * so every line gets a stream of its own, and the same seed always gives every line the same one.
+ *
+ * @param seed Seed of the whole batch.
+ * @param line Line number in the file, counting from 1.
+ * @return Returns the line's seed.
+ */
+uint32_t Jobs::line_seed(uint32_t seed, uint64_t line)
+{
+    uint64_t z = ((static_cast<uint64_t>(seed) << 32) ^ line) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<uint32_t>(z ^ (z >> 31));
+}
+
+/**
+ * @brief HELPER - Works out whether a warden runs the prisoners on threads or processes of their own.
+ *
+ * @param w Warden of a job.
+ * @return Returns true for the os, handoff, process, and coro wardens, false otherwise.
+ */
+bool Jobs::is_threaded(warden w)
+{
+    return w == warden::os || w == warden::handoff || w == warden::process || w == warden::coro;
+}
@@ -6,8 +6,13 @@ Isaac Jung
 |===========================================================================================================|
 */
 
+#include <algorithm>
 #include <iostream>
 #include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "ensemble.h"
 #include "global.h"
 #include "parser.h"
 
@@ -21,36 +26,254 @@ Isaac Jung
  */
 void Parser::parse(int32_t argc, char *argv[])
 {
-    Parser::parse_called = true;
-
-    int32_t itr = 1;
-    bool multichar = false;
-
-    while (itr < argc) {
-        std::string arg(argv[itr]);         // cast to std::string
-
-        if (multichar) {                                // options
-            Parser::handle_option(arg);
-            multichar = false;
-        
-        
-        } else if (arg.at(0) == '-') {                  // flags
-            if (arg.length() > 1 && arg.at(1) == '-') {
-                multichar = true;
-                continue;
-            }
-            Parser::handle_flags(arg);
-            
-        } else Parser::handle_argument(arg);            // arguments
-
-        itr++;
-    }
+    Parser::parsed = Config();
+    Parser::parsed.output = out_mode::normal;   // unlike the library, the program prints by default
+    std::vector<std::string> args(argv + std::min(argc, 1), argv + argc);
+    Parser::handle_arguments(args, &Parser::parsed);
+    Parser::given = Parser::parsed;
+
+    Parser::seed_from_user = Parser::parsed.seed_provided;
+    Parser::check(Parser::parsed, true);
+    Parser::given.seed = Parser::parsed.seed;
+    Parser::given.seed_provided = true;
+    Parser::adopt(&Parser::parsed);
+}
 
-    if (!Parser::seed_provided) {
+/**
+ * @brief INITIALIZER - Parses one line of arguments, written the same way as on the command line.
+ *
+ * @details Used for the lines of a jobs file. Nothing is checked or put in effect, so this may be called any
+ * number of times, and the result handed to Simulator::run().
+ *
+ * @param line Arguments separated by whitespace.
+ * @param base Configuration whose settings are kept wherever the line doesn't change them.
+ * @return Returns the configuration the line describes.
+ */
+Config Parser::parse_line(const std::string& line, const Config& base)
+{
+    std::vector<std::string> args;
+    std::istringstream in(line);
+    std::string arg;
+    while (in >> arg) args.push_back(arg);
+
+    Config config = base;
+    Parser::handle_arguments(args, &config);
+    return config;
+}
+
+/**
+ * @brief HELPER - Settles a configuration, picking a seed if it has none and turning off what can't be used.
+ *
+ * @details Called by parse() on what it found, and by Simulator::run() on what it was given. Checking the
+ * same configuration again changes nothing, so nothing is noted twice.
+ *
+ * @param config Configuration to settle, changed in place.
+ * @param notes Whether to print a note about each setting that had to be changed.
+ */
+void Parser::check(Config& config, bool notes)
+{
+    if (!config.seed_provided) {
         std::random_device rd;
         std::mt19937 temp(rd());
         std::uniform_int_distribution<uint32_t> seed_distribution(0, UINT32_MAX);
-        Parser::seed = seed_distribution(temp);
+        config.seed = seed_distribution(temp);
+        config.seed_provided = true;
+    }
+
+    // records written to stdout would be mixed up with the regular output, so that goes quiet instead
+    if (config.format != out_format::f_text && config.output_path.empty()) {
+        config.output = out_mode::silent;
+        config.verbose = verb_mode::v_off;
+    }
+
+    // importance sampling only knows how to reweigh the pseudo warden's picks, and only improper runs fail
+    if (config.bias > 0.0 &&
+        (config.warden_type != warden::pseudo || config.strategy_type != strategy::improper)) {
+        if (notes) std::cout << "NOTE: --bias only applies to the pseudo warden with the improper " <<
+            "strategy; ignored" << std::endl;
+        config.bias = 0.0;
+    }
+
+    // parallel workers each run whole challenges, which only works when those are single threaded and quiet
+    bool adaptive = config.ci > 0.0 || config.entries_ci > 0.0;
+    if (adaptive) {
+        if (config.workers == 0) config.workers = static_cast<int32_t>(std::max(1u,
+            std::thread::hardware_concurrency()));
+        bool threaded = config.warden_type == warden::os || config.warden_type == warden::handoff ||
+            config.warden_type == warden::process || config.warden_type == warden::coro;
+        if (config.workers > 1 && threaded) {
+            if (notes) std::cout << "NOTE: threaded wardens can't run trials in parallel; using 1 worker" <<
+                std::endl;
+            config.workers = 1;
+        }
+        if (config.workers > 1 && config.output != out_mode::silent) {
+            if (notes) std::cout << "NOTE: running trials in parallel forces silent mode" << std::endl;
+            config.output = out_mode::silent;
+            config.verbose = verb_mode::v_off;
+        }
+        if (config.workers > 1 && config.counters) {
+            if (notes) std::cout << "NOTE: performance counters can't be used by parallel workers; ignored" <<
+                std::endl;
+            config.counters = false;
+        }
+    }
+
+    // a jobs file's runs go on side by side, while these outputs belong to the whole process
+    if (!config.jobs_path.empty()) {
+        if (config.workers == 0) config.workers = static_cast<int32_t>(std::max(1u,
+            std::thread::hardware_concurrency()));
+        if (config.counters) {
+            if (notes) std::cout << "NOTE: performance counters can't follow a batch of jobs; ignored" <<
+                std::endl;
+            config.counters = false;
+        }
+        if (config.progress_ms > 0) {
+            if (notes) std::cout << "NOTE: --progress can't follow a batch of jobs; ignored" << std::endl;
+            config.progress_ms = 0;
+        }
+        if (!config.trace_path.empty()) {
+            if (notes) std::cout << "NOTE: --trace can't follow a batch of jobs; ignored" << std::endl;
+            config.trace_path = "";
+        }
+    }
+
+    // every room needs someone to count in it
+    if (static_cast<uint32_t>(config.rooms) > config.prisoners) {
+        if (notes) std::cout << "NOTE: there can't be more switch rooms than prisoners; using " <<
+            std::max(config.prisoners, 1u) << " room(s)" << std::endl;
+        config.rooms = static_cast<int32_t>(std::max(config.prisoners, 1u));
+    }
+
+    // the handoff warden's queue of waiting prisoners belongs to a single room
+    if (config.rooms > 1 && config.warden_type == warden::handoff) {
+        if (notes) std::cout << "NOTE: the handoff warden only has 1 switch room; --rooms ignored" <<
+            std::endl;
+        config.rooms = 1;
+    }
+
+    // the progress snapshot has room for one writer, so it can only follow one prison at a time
+    if (config.progress_ms > 0 && adaptive && config.workers > 1) {
+        if (notes) std::cout << "NOTE: --progress can only follow 1 worker; ignored" << std::endl;
+        config.progress_ms = 0;
+    }
+
+    // ...and one room at a time
+    if (config.progress_ms > 0 && config.rooms > 1) {
+        if (notes) std::cout << "NOTE: --progress can only follow 1 switch room; ignored" << std::endl;
+        config.progress_ms = 0;
+    }
+
+    // the coro warden's pool hands a single room around, and has a thread per CPU unless told otherwise
+    if (config.rooms > 1 && config.warden_type == warden::coro) {
+        if (notes) std::cout << "NOTE: the coro warden only has 1 switch room; --rooms ignored" << std::endl;
+        config.rooms = 1;
+    }
+    if (config.pool == 0)
+        config.pool = static_cast<int32_t>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // prisoner processes can't reach the progress snapshot or the trace buffers, which are the program's own
+    if (config.progress_ms > 0 && config.warden_type == warden::process) {
+        if (notes) std::cout << "NOTE: --progress can't follow prisoner processes; ignored" << std::endl;
+        config.progress_ms = 0;
+    }
+    if (!config.trace_path.empty() && config.warden_type == warden::process) {
+        if (notes) std::cout << "NOTE: --trace can't follow prisoner processes; ignored" << std::endl;
+        config.trace_path = "";
+    }
+
+    // the ensemble only knows the pseudo warden's uniform picks in a single room, and never enters the prison
+    if (config.ensemble != ensemble_mode::e_off) {
+        if (config.warden_type != warden::pseudo || config.rooms > 1 || config.bias > 0.0) {
+            if (notes) std::cout << "NOTE: --ensemble only applies to the pseudo warden with 1 switch " <<
+                "room and no --bias; ignored" << std::endl;
+            config.ensemble = ensemble_mode::e_off;
+        } else if (config.prisoners > Ensemble::MAX_PRISONERS || config.prisoners == 0) {
+            if (notes) std::cout << "NOTE: --ensemble only handles from 1 to " << Ensemble::MAX_PRISONERS <<
+                " prisoners; ignored" << std::endl;
+            config.ensemble = ensemble_mode::e_off;
+        }
+    }
+    if (config.ensemble != ensemble_mode::e_off) {
+        if (!Ensemble::supports(config.ensemble)) {
+            if (notes) std::cout << "NOTE: the CPU doesn't support the " << Ensemble::name(config.ensemble) <<
+                " ensemble engine; using the widest one it does" << std::endl;
+            config.ensemble = ensemble_mode::e_auto;
+        }
+        if (config.output != out_mode::silent) {
+            if (notes) std::cout << "NOTE: --ensemble forces silent mode" << std::endl;
+            config.output = out_mode::silent;
+            config.verbose = verb_mode::v_off;
+        }
+        if (config.counters) {
+            if (notes) std::cout << "NOTE: performance counters can't follow the ensemble; ignored" <<
+                std::endl;
+            config.counters = false;
+        }
+        if (config.progress_ms > 0) {
+            if (notes) std::cout << "NOTE: --progress can't follow the ensemble; ignored" << std::endl;
+            config.progress_ms = 0;
+        }
+    }
+}
+
+/**
+ * @brief SETTER - Puts a configuration in effect on the calling thread.
+ *
+ * @details Every thread the simulator starts calls this with the configuration of the thread that started
+ * it, before calling any getter. The configuration is not copied, so it must outlive its use.
+ *
+ * @param config Configuration to put in effect, or nullptr for none.
+ * @return Returns the configuration that was in effect before, so that it can be put back.
+ */
+const Config* Parser::adopt(const Config* config)
+{
+    const Config* previous = Parser::active;
+    Parser::active = config;
+    return previous;
+}
+
+/**
+ * @brief GETTER - Interface for getting the whole configuration in effect on the calling thread.
+ *
+ * @return Returns a reference to it, valid for as long as it stays in effect.
+ * @throws std::logic_error When no configuration is in effect, because neither parse() nor
+ * Simulator::run() has been called first.
+ */
+const Config& Parser::get_config()
+{
+    if (Parser::active == nullptr) throw std::logic_error("Parser::parse() must be called first");
+
+    return *Parser::active;
+}
+
+/**
+ * @brief GETTER - Interface for getting the configuration as the command line gave it.
+ *
+ * @details Unlike get_config(), nothing has been turned off for not fitting with the rest, so that a jobs
+ * file can start from it and change whatever it likes; only the seed is the one check() picked.
+ *
+ * @return Returns a reference to it, valid until parse() is called again.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+const Config& Parser::get_given_config()
+{
+    Parser::get_config();
+    return Parser::given;
+}
+
+/**
+ * @brief HELPER - Sorts arguments into options, flags, and the number of prisoners, and handles each.
+ *
+ * @param args Arguments, one per entry, without the program's name.
+ * @param c Configuration to change.
+ */
+void Parser::handle_arguments(const std::vector<std::string>& args, Config* c)
+{
+    uint32_t numbers = 0;   // int arguments seen so far; only the first is the number of prisoners
+    for (const std::string& arg : args) {
+        if (arg.length() > 1 && arg.at(0) == '-' && arg.at(1) == '-') Parser::handle_option(arg, c);
+        else if (!arg.empty() && arg.at(0) == '-') Parser::handle_flags(arg, c);
+        else Parser::handle_argument(arg, c, &numbers);
     }
 }
 
@@ -58,9 +281,11 @@ void Parser::parse(int32_t argc, char *argv[])
  * @brief HELPER - Handles the logic for command line arguments beginning with "--". These are options.
  * 
  * @param arg String containing a single command line argument.
+ * @param config Configuration to change.
  */
-void Parser::handle_option(const std::string& arg)
+void Parser::handle_option(const std::string& arg, Config* config)
 {
+    Config& c = *config;
     size_t pos = arg.find('=');
     if (pos == std::string::npos) {
         std::cout << "NOTE: option \'" << arg <<
@@ -70,58 +295,256 @@ void Parser::handle_option(const std::string& arg)
     std::string option = arg.substr(2, pos - 2);    // extract the option
     std::string value = arg.substr(pos + 1);        // extract the value
     if (option == "i" || option == "init" || option == "initial" || option == "initial_state") {
-        if (value == "on" || value == "1" || value == "up" || value == "set") Parser::i_s = switch_state::on;
+        if (value == "on" || value == "1" || value == "up" || value == "set")
+            c.initial_state = switch_state::on;
         else if (value == "off" || value == "0" || value == "down" || value == "reset")
-            Parser::i_s = switch_state::off;
-        else if (value != "unknown") std::cout << "NOTE: \'" << value <<
-            "\' is not a valid initial switch state; ignored" << std::endl;
+            c.initial_state = switch_state::off;
+        else if (value == "unknown") c.initial_state = switch_state::unknown;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid initial switch state; ignored" <<
+            std::endl;
     } else if (option == "w" || option == "ward" || option == "warden") {
         if (value == "pseudo" || value == "pseudorand" || value == "pseudorandom" || value == "rand" ||
-            value == "random") Parser::w = warden::pseudo;
-        else if (value == "fixed") Parser::w = warden::fixed;
-        else if (value == "seq" || value == "sequential") Parser::w = warden::seq;
-        else if (value == "fast") Parser::w = warden::fast;
+            value == "random") c.warden_type = warden::pseudo;
+        else if (value == "fixed") c.warden_type = warden::fixed;
+        else if (value == "seq" || value == "sequential") c.warden_type = warden::seq;
+        else if (value == "fast") c.warden_type = warden::fast;
+        else if (value == "handoff" || value == "directed") c.warden_type = warden::handoff;
+        else if (value == "weighted" || value == "skewed") c.warden_type = warden::weighted;
+        else if (value == "event" || value == "des" || value == "discrete") c.warden_type = warden::event;
+        else if (value == "cfs" || value == "fair") c.warden_type = warden::cfs;
+        else if (value == "process" || value == "proc" || value == "fork") c.warden_type = warden::process;
+        else if (value == "coro" || value == "coroutine" || value == "green") c.warden_type = warden::coro;
         else if (value != "os") std::cout << "NOTE: \'" << value <<
             "\' is not a valid warden type; ignored" << std::endl;
     } else if (option == "st" || option == "strat" || option == "strategy") {
-        if (value == "i" || value == "improper") Parser::strat = strategy::improper;
+        if (value == "i" || value == "improper") c.strategy_type = strategy::improper;
         else if (value != "p" && value != "proper") std::cout << "NOTE: \'" << value <<
             "\' is not a valid strategy specifier; ignored" << std::endl;
     } else if (option == "se" || option == "seed") {
         try {
-            Parser::seed = std::stoul(value);
-            Parser::seed_provided = true;
+            c.seed = std::stoul(value);
+            c.seed_provided = true;
         } catch (...) {
             std::cout << "NOTE: \'" << value << "\' isn\'t a valid seed value; ignored" << std::endl;
         }
+    } else if (option == "pol" || option == "sched" || option == "policy") {
+        if (!Parser::handle_policy(value, &c.policy)) std::cout << "NOTE: \'" << value <<
+            "\' is not a valid scheduling policy; ignored" << std::endl;
+    } else if (option == "rpol" || option == "resetter_sched" || option == "resetter_policy") {
+        if (Parser::handle_policy(value, &c.resetter_policy)) c.resetter_policy_provided = true;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid scheduling policy; ignored" << std::endl;
+    } else if (option == "n" || option == "nice") {
+        if (Parser::handle_int(value, -20, 19, &c.nice)) c.nice_provided = true;
+        else std::cout << "NOTE: \'" << value << "\' isn\'t a valid nice value (-20 to 19); ignored" <<
+            std::endl;
+    } else if (option == "rn" || option == "resetter_nice") {
+        if (Parser::handle_int(value, -20, 19, &c.resetter_nice)) c.resetter_nice_provided = true;
+        else std::cout << "NOTE: \'" << value << "\' isn\'t a valid nice value (-20 to 19); ignored" <<
+            std::endl;
+    } else if (option == "prio" || option == "priority") {
+        if (!Parser::handle_int(value, 1, 99, &c.priority)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid priority (1 to 99); ignored" << std::endl;
+    } else if (option == "rprio" || option == "resetter_priority") {
+        if (Parser::handle_int(value, 1, 99, &c.resetter_priority)) c.resetter_priority_provided = true;
+        else std::cout << "NOTE: \'" << value << "\' isn\'t a valid priority (1 to 99); ignored" << std::endl;
+    } else if (option == "ho" || option == "handoff") {
+        if (value == "random" || value == "rand") c.handoff = handoff_policy::h_random;
+        else if (value == "rr" || value == "roundrobin") c.handoff = handoff_policy::h_rr;
+        else if (value == "lrv" || value == "least_recent") c.handoff = handoff_policy::h_lrv;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid handoff policy; ignored" << std::endl;
+    } else if (option == "tr" || option == "trials") {
+        if (!Parser::handle_int(value, 1, INT32_MAX, &c.trials)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid number of trials (must be >= 1); ignored" << std::endl;
+    } else if (option == "start") {
+        if (value == "gate" || value == "barrier") c.start = start_mode::s_gate;
+        else if (value == "stagger" || value == "staggered") c.start = start_mode::s_stagger;
+        else if (value == "free" || value == "none") c.start = start_mode::s_free;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid start mode; ignored" << std::endl;
+    } else if (option == "stagger") {
+        if (!Parser::handle_int(value, 0, 1000000, &c.stagger)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid stagger in microseconds (0 to 1000000); ignored" << std::endl;
+    } else if (option == "park") {
+        if (value == "on" || value == "1" || value == "yes") c.park = true;
+        else if (value == "off" || value == "0" || value == "no") c.park = false;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid park setting; ignored" << std::endl;
+    } else if (option == "pin") {
+        if (value == "on" || value == "1" || value == "yes") c.pin = true;
+        else if (value == "off" || value == "0" || value == "no") c.pin = false;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid pin setting; ignored" << std::endl;
+    } else if (option == "weights") {
+        if (value == "zipf") c.weights = weight_source::w_zipf;
+        else if (value.rfind("zipf:", 0) == 0) {
+            if (Parser::handle_double(value.substr(5), 0.0, 100.0, &c.zipf_exponent))
+                c.weights = weight_source::w_zipf;
+            else std::cout << "NOTE: \'" << value.substr(5) <<
+                "\' isn\'t a valid Zipf exponent (0 to 100); ignored" << std::endl;
+        } else if (value.rfind("file:", 0) == 0 && value.length() > 5) {
+            c.weights = weight_source::w_file;
+            c.weights_path = value.substr(5);
+        } else std::cout << "NOTE: \'" << value << "\' is not a valid weight source; ignored" << std::endl;
+    } else if (option == "arrivals" || option == "arr") {
+        if (value == "exp" || value == "exponential" || value == "poisson")
+            c.arrivals = arrival_mode::a_exp;
+        else if (value == "uniform" || value == "uni") c.arrivals = arrival_mode::a_uniform;
+        else if (value == "fixed" || value == "periodic") c.arrivals = arrival_mode::a_fixed;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid arrival distribution; ignored" <<
+            std::endl;
+    } else if (option == "period" || option == "per") {
+        if (!Parser::handle_double(value, 1e-9, 1e12, &c.period)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid period in days (must be > 0); ignored" << std::endl;
+    } else if (option == "granularity" || option == "gran") {
+        if (!Parser::handle_int(value, 1, 1000000000, &c.granularity)) std::cout << "NOTE: \'" <<
+            value << "\' isn\'t a valid granularity in nanoseconds (1 to 1000000000); ignored" << std::endl;
+    } else if (option == "visit_cost" || option == "cost") {
+        if (!Parser::handle_int(value, 1, 1000000000, &c.visit_cost)) std::cout << "NOTE: \'" <<
+            value << "\' isn\'t a valid visit cost in nanoseconds (1 to 1000000000); ignored" << std::endl;
+    } else if (option == "ci") {
+        if (!Parser::handle_double(value, 1e-6, 0.5, &c.ci)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid success rate half-width (1e-6 to 0.5); ignored" << std::endl;
+    } else if (option == "entries_ci" || option == "eci") {
+        if (!Parser::handle_double(value, 1e-6, 1.0, &c.entries_ci)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid relative half-width for entries (1e-6 to 1); ignored" << std::endl;
+    } else if (option == "budget") {
+        if (!Parser::handle_int(value, 1, INT32_MAX, &c.budget)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid trial budget (must be >= 1); ignored" << std::endl;
+    } else if (option == "workers" || option == "wk") {
+        if (!Parser::handle_int(value, 1, 1024, &c.workers)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid number of workers (1 to 1024); ignored" << std::endl;
+    } else if (option == "bias" || option == "is") {
+        if (!Parser::handle_double(value, 1.0, 1e6, &c.bias)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid importance sampling bias (1 to 1000000); ignored" << std::endl;
+    } else if (option == "format" || option == "fmt") {
+        if (value == "text" || value == "txt") c.format = out_format::f_text;
+        else if (value == "json" || value == "jsonl") c.format = out_format::f_json;
+        else if (value == "csv") c.format = out_format::f_csv;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid format; ignored" << std::endl;
+    } else if (option == "output" || option == "out") {
+        c.output_path = value;
+    } else if (option == "progress" || option == "prog") {
+        if (!Parser::handle_int(value, 1, 3600000, &c.progress_ms)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid progress interval in milliseconds (1 to 3600000); ignored" << std::endl;
+    } else if (option == "progress_file" || option == "pf") {
+        c.progress_path = value;
+    } else if (option == "stack" || option == "stk") {
+        if (!Parser::handle_int(value, 16, 1048576, &c.stack_kib)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid stack size in KiB (16 to 1048576); ignored" << std::endl;
+    } else if (option == "pool") {
+        if (!Parser::handle_int(value, 1, 1024, &c.pool)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid number of pool threads (1 to 1024); ignored" << std::endl;
+    } else if (option == "rooms" || option == "rm") {
+        if (!Parser::handle_int(value, 1, 1048576, &c.rooms)) std::cout << "NOTE: \'" << value <<
+            "\' isn\'t a valid number of switch rooms (1 to 1048576); ignored" << std::endl;
+    } else if (option == "trace") {
+        c.trace_path = value;
+    } else if (option == "jobs" || option == "batch") {
+        c.jobs_path = value;
+    } else if (option == "ensemble" || option == "ens") {
+        if (value == "off" || value == "0" || value == "no") c.ensemble = ensemble_mode::e_off;
+        else if (value == "on" || value == "auto" || value == "1" || value == "yes")
+            c.ensemble = ensemble_mode::e_auto;
+        else if (value == "avx512") c.ensemble = ensemble_mode::e_avx512;
+        else if (value == "avx2") c.ensemble = ensemble_mode::e_avx2;
+        else if (value == "scalar") c.ensemble = ensemble_mode::e_scalar;
+        else std::cout << "NOTE: \'" << value << "\' is not a valid ensemble engine; ignored" << std::endl;
     } else std::cout << "NOTE: \'" << option << "\' isn\'t a valid option; ignored" << std::endl;
 }
 
+/**
+ * @brief HELPER - Translates the value of a scheduling policy option.
+ * 
+ * @param value String given after the = of the option.
+ * @param target Where to store the policy when the value is valid.
+ * @return Returns true when the value named a policy, false otherwise (target is left untouched).
+ */
+bool Parser::handle_policy(const std::string& value, sched_policy* target)
+{
+    if (value == "inherit" || value == "default") *target = sched_policy::p_inherit;
+    else if (value == "other" || value == "normal" || value == "cfs") *target = sched_policy::p_other;
+    else if (value == "batch") *target = sched_policy::p_batch;
+    else if (value == "idle") *target = sched_policy::p_idle;
+    else if (value == "fifo") *target = sched_policy::p_fifo;
+    else if (value == "rr" || value == "roundrobin") *target = sched_policy::p_rr;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief HELPER - Translates the value of an option that must be a bounded integer.
+ * 
+ * @param value String given after the = of the option.
+ * @param min Smallest acceptable value.
+ * @param max Largest acceptable value.
+ * @param target Where to store the integer when the value is valid.
+ * @return Returns true when the value was parsed and in range, false otherwise (target is left untouched).
+ */
+bool Parser::handle_int(const std::string& value, int32_t min, int32_t max, int32_t* target)
+{
+    try {
+        size_t used = 0;
+        int32_t param = std::stoi(value, &used);
+        if (used != value.length() || param < min || param > max) return false;
+        *target = param;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+/**
+ * @brief HELPER - Translates the value of an option that must be a bounded real number.
+ * 
+ * @param value String given after the = of the option (or after the : within it).
+ * @param min Smallest acceptable value.
+ * @param max Largest acceptable value.
+ * @param target Where to store the number when the value is valid.
+ * @return Returns true when the value was parsed and in range, false otherwise (target is left untouched).
+ */
+bool Parser::handle_double(const std::string& value, double min, double max, double* target)
+{
+    try {
+        size_t used = 0;
+        double param = std::stod(value, &used);
+        if (used != value.length() || !(param >= min && param <= max)) return false;
+        *target = param;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
 /**
  * @brief HELPER - Handles the logic for command line arguments beginning with "-". These are flags.
  * 
  * @param arg String containing a single command line argument.
+ * @param target Configuration to change.
  */
-void Parser::handle_flags(const std::string& arg)
+void Parser::handle_flags(const std::string& arg, Config* target)
 {
+    Config& config = *target;
     for (char c : arg.substr(1, arg.length() - 1)) {
         switch(c) {
             case 'd':
-                Parser::d = debug_mode::d_on;
+                config.debug = debug_mode::d_on;
                 break;
             case 'v':
-                if (Parser::o == out_mode::silent)
+                if (config.output == out_mode::silent)
                     std::cout << "NOTE: found -v after -s; ignored (silent overrides verbose)" << std::endl;
-                else Parser::v = verb_mode::v_on;
+                else config.verbose = verb_mode::v_on;
                 break;
             case 'h':
-                Parser::o = out_mode::halfway;
+                config.output = out_mode::halfway;
+                break;
+            case 'p':
+                config.counters = true;
+                break;
+            case 't':
+                config.timing = true;
                 break;
             case 's':
-                Parser::o = out_mode::silent;
-                if (Parser::v == verb_mode::v_on)
+                config.output = out_mode::silent;
+                if (config.verbose == verb_mode::v_on)
                     std::cout << "NOTE: found -s after -v; silent mode forces verbose mode off" << std::endl;
-                Parser::v = verb_mode::v_off;
+                config.verbose = verb_mode::v_off;
                 break;
             default:
                 try {
@@ -140,16 +563,17 @@ void Parser::handle_flags(const std::string& arg)
  * @brief HELPER - Handles the logic for any command line arguments not specified with "-" or "--".
  * 
  * @param arg String containing a single command line argument.
+ * @param c Configuration to change.
+ * @param numbers Number of int arguments seen so far among the same arguments, counted up here.
  */
-void Parser::handle_argument(const std::string& arg)
+void Parser::handle_argument(const std::string& arg, Config* c, uint32_t* numbers)
 {
-    static uint32_t num_params = 0;
     try {   // see if it is an int
         uint32_t param = static_cast<uint32_t>(std::stoi(arg));
-        if (num_params < 1) Parser::num_p = param;
+        if (*numbers < 1) c->prisoners = param;
         else std::cout << "NOTE: too many int arguments given; ignored <" << arg <<
             "> (the only argument in this program is for the number of prisoners)" << std::endl;
-        num_params++;
+        (*numbers)++;
     } catch ( ... ) {
         std::cout << "NOTE: couldn't parse command line argument <" << arg << ">; ignored" << std::endl;
     }
@@ -163,9 +587,7 @@ void Parser::handle_argument(const std::string& arg)
  */
 bool Parser::debug_is_on()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
-
-    return Parser::d == debug_mode::d_on;
+    return Parser::get_config().debug == debug_mode::d_on;
 }
 
 /**
@@ -176,9 +598,7 @@ bool Parser::debug_is_on()
  */
 bool Parser::verbose_is_on()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
-
-    return Parser::v == verb_mode::v_on;
+    return Parser::get_config().verbose == verb_mode::v_on;
 }
 
 /**
@@ -189,9 +609,64 @@ bool Parser::verbose_is_on()
  */
 out_mode Parser::get_output_mode()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
+    return Parser::get_config().output;
+}
 
-    return Parser::o;
+/**
+ * @brief GETTER - Interface for getting the format of the record written for every challenge.
+ *
+ * @return Returns an out_format as defined in parser.h.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+out_format Parser::get_format()
+{
+    return Parser::get_config().format;
+}
+
+/**
+ * @brief GETTER - Interface for getting the file that records should be written to.
+ *
+ * @return Returns the path given by "--output", or an empty string for stdout.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+std::string Parser::get_output_path()
+{
+    return Parser::get_config().output_path;
+}
+
+/**
+ * @brief GETTER - Interface for getting whether records are written to stdout, leaving no room for text.
+ *
+ * @return Returns true when the format is json or csv and no output file was given, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::records_own_stdout()
+{
+    const Config& c = Parser::get_config();
+
+    return c.format != out_format::f_text && c.output_path.empty();
+}
+
+/**
+ * @brief GETTER - Interface for getting whether performance counters should be collected.
+ *
+ * @return Returns true when the -p flag was given, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::counters_are_on()
+{
+    return Parser::get_config().counters;
+}
+
+/**
+ * @brief GETTER - Interface for getting whether the phase timing breakdown should be printed.
+ *
+ * @return Returns true when the -t flag was given, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::timing_is_on()
+{
+    return Parser::get_config().timing;
 }
 
 /**
@@ -202,9 +677,7 @@ out_mode Parser::get_output_mode()
  */
 uint32_t Parser::get_number_of_prisoners()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
-
-    return Parser::num_p;
+    return Parser::get_config().prisoners;
 }
 
 /**
@@ -215,9 +688,7 @@ uint32_t Parser::get_number_of_prisoners()
  */
 switch_state Parser::get_initial_switch_state()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
-
-    return Parser::i_s;
+    return Parser::get_config().initial_state;
 }
 
 /**
@@ -228,9 +699,7 @@ switch_state Parser::get_initial_switch_state()
  */
 warden Parser::get_warden()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
-
-    return Parser::w;
+    return Parser::get_config().warden_type;
 }
 
 
@@ -242,9 +711,7 @@ warden Parser::get_warden()
  */
 strategy Parser::get_strategy()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
-
-    return Parser::strat;
+    return Parser::get_config().strategy_type;
 }
 
 /**
@@ -255,9 +722,7 @@ strategy Parser::get_strategy()
  */
 bool Parser::seed_is_from_user()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
-
-    return Parser::seed_provided;
+    return Parser::seed_from_user;
 }
 
 /**
@@ -268,8 +733,404 @@ bool Parser::seed_is_from_user()
  */
 uint32_t Parser::get_seed()
 {
-    if (!Parser::parse_called) throw std::logic_error("Parser::parse() must be called first");
+    return Parser::get_config().seed;
+}
+
+/**
+ * @brief GETTER - Interface for getting the scheduling policy that prisoner threads should use.
+ *
+ * @param resetter Use true to ask about the resetter's thread, which falls back to the setters' policy
+ *  unless a resetter-specific policy was given.
+ * @return Returns a sched_policy as defined in enums.h.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+sched_policy Parser::get_sched_policy(bool resetter)
+{
+    const Config& c = Parser::get_config();
+
+    return (resetter && c.resetter_policy_provided) ? c.resetter_policy : c.policy;
+}
+
+/**
+ * @brief GETTER - Interface for getting whether a nice value should be applied to prisoner threads.
+ *
+ * @param resetter Use true to ask about the resetter's thread.
+ * @return Returns true when a nice value was given on the command line, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::nice_is_set(bool resetter)
+{
+    const Config& c = Parser::get_config();
+
+    return c.nice_provided || (resetter && c.resetter_nice_provided);
+}
+
+/**
+ * @brief GETTER - Interface for getting the nice value that prisoner threads should use.
+ *
+ * @param resetter Use true to ask about the resetter's thread, which falls back to the setters' value
+ *  unless a resetter-specific value was given.
+ * @return Returns an integer from -20 to 19.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+int32_t Parser::get_nice(bool resetter)
+{
+    const Config& c = Parser::get_config();
+
+    return (resetter && c.resetter_nice_provided) ? c.resetter_nice : c.nice;
+}
+
+/**
+ * @brief GETTER - Interface for getting the real-time priority that prisoner threads should use.
+ *
+ * @details The priority only matters for the fifo and rr policies; every other policy requires 0.
+ *
+ * @param resetter Use true to ask about the resetter's thread, which falls back to the setters' value
+ *  unless a resetter-specific value was given.
+ * @return Returns an integer from 1 to 99.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+int32_t Parser::get_sched_priority(bool resetter)
+{
+    const Config& c = Parser::get_config();
+
+    return (resetter && c.resetter_priority_provided) ? c.resetter_priority : c.priority;
+}
+
+/**
+ * @brief GETTER - Interface for getting how prisoner threads are released when the warden is the OS.
+ *
+ * @return Returns a start_mode as defined in enums.h.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+start_mode Parser::get_start_mode()
+{
+    return Parser::get_config().start;
+}
+
+/**
+ * @brief GETTER - Interface for getting the delay between releases when the start mode is stagger.
+ *
+ * @return Returns a number of microseconds from 0 to 1000000.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+int32_t Parser::get_stagger()
+{
+    return Parser::get_config().stagger;
+}
+
+/**
+ * @brief GETTER - Interface for getting whether prisoner threads should be pinned to CPUs.
+ *
+ * @return Returns true when "--pin=on" was given, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::pin_is_on()
+{
+    return Parser::get_config().pin;
+}
+
+/**
+ * @brief GETTER - Interface for getting the stack size each prisoner thread is created with.
+ *
+ * @return Returns a number of bytes, 128 KiB unless "--stack" was given.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+size_t Parser::get_stack_size()
+{
+    return static_cast<size_t>(Parser::get_config().stack_kib) * 1024;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many threads run the prisoners under the coro warden.
+ *
+ * @return Returns an integer from 1 to 1024, one per CPU unless "--pool" was given.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint32_t Parser::get_pool_size()
+{
+    return static_cast<uint32_t>(Parser::get_config().pool);
+}
+
+/**
+ * @brief GETTER - Interface for getting how many switch rooms the prison has.
+ *
+ * @return Returns an integer from 1 to the number of prisoners, 1 unless "--rooms" was given.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint32_t Parser::get_rooms()
+{
+    return static_cast<uint32_t>(Parser::get_config().rooms);
+}
+
+/**
+ * @brief GETTER - Interface for getting how the next prisoner is chosen under the handoff or coro warden.
+ *
+ * @return Returns a handoff_policy as defined in enums.h.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+handoff_policy Parser::get_handoff_policy()
+{
+    return Parser::get_config().handoff;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many challenges should be run one after another.
+ *
+ * @return Returns an integer greater than or equal to 1.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint32_t Parser::get_trials()
+{
+    return static_cast<uint32_t>(Parser::get_config().trials);
+}
+
+/**
+ * @brief GETTER - Interface for getting whether finished setters should park their threads.
+ *
+ * @return Returns true when "--park=on" was given, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::park_is_on()
+{
+    return Parser::get_config().park;
+}
+
+/**
+ * @brief GETTER - Interface for getting where the weighted warden's per-prisoner weights come from.
+ *
+ * @return Returns a weight_source as defined in enums.h.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+weight_source Parser::get_weight_source()
+{
+    return Parser::get_config().weights;
+}
+
+/**
+ * @brief GETTER - Interface for getting the exponent of the Zipf law used by the weighted warden.
+ *
+ * @return Returns a non-negative real number; 0 makes every prisoner equally likely, like pseudo.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+double Parser::get_zipf_exponent()
+{
+    return Parser::get_config().zipf_exponent;
+}
+
+/**
+ * @brief GETTER - Interface for getting the file the weighted warden should read its weights from.
+ *
+ * @return Returns the path given by "--weights=file:<path>", or an empty string if none was given.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+std::string Parser::get_weights_path()
+{
+    return Parser::get_config().weights_path;
+}
+
+/**
+ * @brief GETTER - Interface for getting the distribution of the time between visits under the event warden.
+ *
+ * @return Returns an arrival_mode as defined in enums.h.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+arrival_mode Parser::get_arrival_mode()
+{
+    return Parser::get_config().arrivals;
+}
+
+/**
+ * @brief GETTER - Interface for getting the mean number of days between two visits by the same prisoner.
+ *
+ * @details When no period was given, it is the number of prisoners, so that the room sees one visit a day
+ * on average, as in the classic telling of the puzzle.
+ *
+ * @return Returns a positive real number.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+double Parser::get_period()
+{
+    const Config& c = Parser::get_config();
+
+    return c.period > 0.0 ? c.period : static_cast<double>(c.prisoners);
+}
+
+/**
+ * @brief GETTER - Interface for getting the minimum time slice of the cfs warden's emulated scheduler.
+ *
+ * @return Returns a positive number of nanoseconds, 750000 by default (as on Linux).
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint64_t Parser::get_granularity()
+{
+    return static_cast<uint64_t>(Parser::get_config().granularity);
+}
+
+/**
+ * @brief GETTER - Interface for getting how long one visit to the room takes under the cfs warden.
+ *
+ * @return Returns a positive number of nanoseconds, 1000 by default.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint64_t Parser::get_visit_cost()
+{
+    return static_cast<uint64_t>(Parser::get_config().visit_cost);
+}
+
+/**
+ * @brief GETTER - Interface for getting whether trials should run until a confidence interval is narrow.
+ *
+ * @return Returns true when "--ci" or "--entries_ci" was given, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::adaptive_is_on()
+{
+    const Config& c = Parser::get_config();
 
-    return Parser::seed;
+    return c.ci > 0.0 || c.entries_ci > 0.0;
+}
+
+/**
+ * @brief GETTER - Interface for getting the target half-width of the success rate's confidence interval.
+ *
+ * @return Returns a probability, or 0 when there is no target for the success rate.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+double Parser::get_ci()
+{
+    return Parser::get_config().ci;
+}
+
+/**
+ * @brief GETTER - Interface for getting the target half-width of the mean entries' confidence interval.
+ *
+ * @return Returns a fraction of the mean, or 0 when there is no target for the mean number of entries.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+double Parser::get_entries_ci()
+{
+    return Parser::get_config().entries_ci;
+}
+
+/**
+ * @brief GETTER - Interface for getting the most trials an adaptive run may use.
+ *
+ * @return Returns an integer greater than or equal to 1, 1000000 by default.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint32_t Parser::get_budget()
+{
+    return static_cast<uint32_t>(Parser::get_config().budget);
+}
+
+/**
+ * @brief GETTER - Interface for getting how many worker threads an adaptive run or a jobs file should use.
+ *
+ * @return Returns an integer greater than or equal to 1 when adaptive mode or a jobs file is on, 0
+ * otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint32_t Parser::get_workers()
+{
+    return static_cast<uint32_t>(Parser::get_config().workers);
+}
+
+/**
+ * @brief GETTER - Interface for getting whether the pseudo warden should pick with a bias and reweigh.
+ *
+ * @return Returns true when a valid "--bias" was given for the pseudo warden and improper strategy.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::importance_is_on()
+{
+    return Parser::get_config().bias > 0.0;
+}
+
+/**
+ * @brief GETTER - Interface for getting how much more often visited prisoners are picked when reweighing.
+ *
+ * @return Returns a number greater than or equal to 1, or 0 when importance sampling is off.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+double Parser::get_bias()
+{
+    return Parser::get_config().bias;
 }
 
+/**
+ * @brief GETTER - Interface for getting whether a sampler thread should report on the challenge as it runs.
+ *
+ * @return Returns true when a valid "--progress" was given, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::progress_is_on()
+{
+    return Parser::get_config().progress_ms > 0;
+}
+
+/**
+ * @brief GETTER - Interface for getting how long the sampler thread waits between progress lines.
+ *
+ * @return Returns a number of milliseconds, or 0 when progress reports are off.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+uint32_t Parser::get_progress_interval()
+{
+    return static_cast<uint32_t>(Parser::get_config().progress_ms);
+}
+
+/**
+ * @brief GETTER - Interface for getting the file that progress lines should be written to.
+ *
+ * @return Returns the path given by "--progress_file", or an empty string for stderr.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+std::string Parser::get_progress_path()
+{
+    return Parser::get_config().progress_path;
+}
+
+/**
+ * @brief GETTER - Interface for getting the file that the Chrome trace should be written to.
+ *
+ * @return Returns the path given by "--trace", or an empty string when tracing is off.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+std::string Parser::get_trace_path()
+{
+    return Parser::get_config().trace_path;
+}
+
+/**
+ * @brief GETTER - Interface for getting the path of the jobs file, if there is one.
+ *
+ * @return Returns the path, or an empty string when there is one run of the command line's settings.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+std::string Parser::get_jobs_path()
+{
+    return Parser::get_config().jobs_path;
+}
+
+/**
+ * @brief GETTER - Interface for getting which engine runs challenges side by side.
+ *
+ * @return Returns an ensemble_mode as defined in enums.h, e_off when challenges are run in the prison.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+ensemble_mode Parser::get_ensemble_mode()
+{
+    return Parser::get_config().ensemble;
+}
+
+/**
+ * @brief GETTER - Interface for getting whether challenges are run side by side instead of in the prison.
+ *
+ * @return Returns true when a valid "--ensemble" was given for the pseudo warden, false otherwise.
+ * @throws std::logic_error When parse() hasn't been called first.
+ */
+bool Parser::ensemble_is_on()
+{
+    return Parser::get_config().ensemble != ensemble_mode::e_off;
+}
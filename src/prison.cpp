@@ -7,18 +7,44 @@ Isaac Jung
 */
 
 #include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
+#include "cfs.h"
+#include "coroutines.h"
+#include "counters.h"
+#include "events.h"
+#include "importance.h"
 #include "global.h"
 #include "parser.h"
 #include "prison.h"
+#include "progress.h"
+#include "threading.h"
+#include "timing.h"
+#include "trace.h"
 
 /**
  * @brief INITIALIZER - Initializes the prison.
  *
+ * @details A single arena is sized from the number of prisoners, and everything the prison needs is created
+ * inside it. The Mersenne Twister is created first and survives across trials; everything after it is
+ * created by populate(), and is thrown away and recreated by reset() between trials. Under the weighted
+ * warden, the alias table is also built here, once, so every trial draws from the same weights. Under the
+ * process warden, the arena is shared memory, so that the prisoner processes can all reach it.
+ *
+ * @param stream Which worker this prison belongs to; 0 seeds the Twister with the seed itself, while every
+ * other stream mixes the seed with its number, so parallel workers draw independent sequences.
  * @throws std::logic_error When number of prisoners < 1. There needs to be at least 1 resetter.
+ * @throws std::runtime_error When the weighted warden's weights file can't be used, or the process warden's
+ * shared memory can't be had.
  */
-void Prison::init()
+void Prison::init(uint32_t stream)
 {
     int32_t pid = Global::PID;
     if (Parser::debug_is_on()) std::cout << std::endl << "==" << pid << "== In Prison::init()." << std::endl;
@@ -26,28 +52,112 @@ void Prison::init()
 
     uint32_t number_of_prisoners = Parser::get_number_of_prisoners();
     if (number_of_prisoners < 1) throw std::logic_error("Need at least 2 prisoners");
-    Prison::mt = new std::mt19937(Parser::get_seed());
 
     Prison::total_number_of_prisoners = number_of_prisoners;
     Prison::prisoner_unique_index_len = Prison::calculate_prisoner_unique_index_len(number_of_prisoners);
 
-    // generate number_of_prisoners Prisoner objects
-    if (Parser::debug_is_on()) std::cout << "==" << pid << "== Creating " << number_of_prisoners <<
-        " Prisoner objects (" << number_of_prisoners - 1 << " Setters, 1 Resetter)." << std::endl;
-    for (uint32_t index = 1; index < number_of_prisoners; index++) {
-        Prison::prisoners.push_back(new Setter(index));
+    // one arena for everything, with a cache line of slack for aligning each kind of object
+    size_t per_prisoner = std::max({sizeof(Setter), sizeof(Resetter), sizeof(Relay)});
+    size_t per_room = sizeof(SwitchRoom) + sizeof(ProcessKey);
+    size_t bytes = sizeof(std::mt19937) + static_cast<size_t>(number_of_prisoners) * per_prisoner +
+        Parser::get_rooms() * per_room + sizeof(Handoff) + sizeof(Processes) + sizeof(std::atomic<uint64_t>) +
+        5 * Global::CACHE_LINE;
+    Prison::arena = new Arena(bytes, Parser::get_warden() == warden::process);
+    if (stream == 0) Prison::mt = Prison::arena->create<std::mt19937>(Parser::get_seed());
+    else {
+        std::seed_seq sequence{Parser::get_seed(), stream};
+        Prison::mt = Prison::arena->create<std::mt19937>(sequence);
+    }
+    Prison::arena_mark = Prison::arena->mark();
+    Prison::prisoners.reserve(number_of_prisoners);
+    Prison::rooms.reserve(Parser::get_rooms());
+    if (Parser::debug_is_on()) std::cout << "==" << pid << "== Reserved an arena of " << bytes << " bytes." <<
+        std::endl;
+
+    if (Parser::get_warden() == warden::weighted) {
+        std::vector<double> weights = Prison::load_weights(number_of_prisoners);
+        Prison::alias = new AliasTable(weights);
+        if (Parser::debug_is_on()) {
+            double sum = 0.0;
+            for (double weight : weights) sum += weight;
+            auto heaviest = std::max_element(weights.begin(), weights.end());
+            std::cout << "==" << pid << "== Built an alias table; the heaviest prisoner (#" <<
+                heaviest - weights.begin() + 1 << ") is picked " << 100.0 * *heaviest / sum <<
+                "% of the time." << std::endl;
+        }
+    }
+
+    Prison::populate();
+}
+
+/**
+ * @brief HELPER - Works out the weighted warden's per-prisoner weights, in order of unique index.
+ *
+ * @details With Zipf weights, the k-th rank gets 1/k^s and the ranks are shuffled among the prisoners by the
+ * Twister, so which prisoners are the frequent visitors depends on the seed. A weights file must contain
+ * exactly one positive number per prisoner, separated by whitespace. Either way, a prisoner who would be
+ * picked less often than once in 1/MIN_SHARE entries would keep the challenge going practically forever,
+ * since it can't end before everyone has been in, so such weights are refused.
+ *
+ * @param number_of_prisoners Number of prisoners to participate in the challenge.
+ * @return Returns one weight per prisoner.
+ * @throws std::runtime_error When the weights file can't be opened or doesn't hold the right weights, or
+ * when some prisoner's weight is too small next to the sum of them all.
+ */
+std::vector<double> Prison::load_weights(uint32_t number_of_prisoners)
+{
+    std::vector<double> weights;
+    weights.reserve(number_of_prisoners);
+    if (Parser::get_weight_source() == weight_source::w_zipf) {
+        double s = Parser::get_zipf_exponent();
+        for (uint32_t rank = 1; rank <= number_of_prisoners; rank++)
+            weights.push_back(1.0 / std::pow(rank, s));
+        std::shuffle(weights.begin(), weights.end(), *Prison::mt);
+    } else {
+        std::string path = Parser::get_weights_path();
+        std::ifstream file(path);
+        if (!file.is_open()) throw std::runtime_error("Could not open weights file " + path);
+        double weight;
+        while (file >> weight) {
+            if (weight <= 0.0 || !std::isfinite(weight)) throw std::runtime_error("Weights in " + path +
+                " must be finite and positive, and prisoner #" + std::to_string(weights.size() + 1) +
+                "'s is not");
+            weights.push_back(weight);
+        }
+        if (!file.eof())
+            throw std::runtime_error("Weights file " + path + " contains something other than numbers");
+        if (weights.size() != number_of_prisoners) throw std::runtime_error("Weights file " + path +
+            " has " + std::to_string(weights.size()) + " weights, but there are " +
+            std::to_string(number_of_prisoners) + " prisoners");
     }
-    Prison::prisoners.push_back(new Resetter(number_of_prisoners));
 
-    // initialize switch room
-    switch_state initial_state = Parser::get_initial_switch_state();
-    if (initial_state == switch_state::unknown) {
-        std::uniform_int_distribution<uint8_t> distribution(0, 1);
-        initial_state = distribution(*Prison::mt) == 0 ? switch_state::off : switch_state::on;
+    double sum = 0.0;
+    for (double w : weights) sum += w;
+    auto lightest = std::min_element(weights.begin(), weights.end());
+    if (!(*lightest / sum >= Prison::MIN_SHARE)) {  // also catches a weight that underflowed to 0
+        std::ostringstream message;
+        message << "Prisoner #" << lightest - weights.begin() + 1 << " would only be picked with a chance " <<
+            "of " << *lightest / sum << " per entry, so the challenge could practically never end; every " <<
+            "prisoner's weight must be at least " << Prison::MIN_SHARE << " of the sum of them all";
+        throw std::runtime_error(message.str());
     }
-    if (Parser::debug_is_on()) std::cout << "==" << pid << "== Creating switch room in initial position " <<
-        (initial_state == switch_state::on ? "on." : "off.") << std::endl;
-    Prison::switch_room = new SwitchRoom(initial_state);
+    return weights;
+}
+
+/**
+ * @brief INITIALIZER - Prepares the prison for another trial, as if init() had just been called.
+ *
+ * @details The arena is rewound in constant time; only the handoff control, which owns memory outside the
+ * arena, needs its destructor called. The Mersenne Twister carries on where the last trial left it.
+ *
+ * @throws std::logic_error When init() hasn't been called first.
+ */
+void Prison::reset()
+{
+    if (!Prison::init_called) throw std::logic_error("Prison::init() must be called first");
+
+    Prison::clear();
+    Prison::populate();
 }
 
 /**
@@ -60,11 +170,104 @@ void Prison::free_memory()
     else if (Parser::debug_is_on())
         std::cout << std::endl << "==" << Global::PID << "== In Prison::free_memory()." << std::endl;
 
-    for (Prisoner* prisoner : Prison::prisoners) {
-        delete prisoner;
+    Prison::clear();
+    delete Prison::alias;
+    Prison::alias = nullptr;
+    delete Prison::arena;
+    Prison::arena = nullptr;
+    Prison::mt = nullptr;
+}
+
+/**
+ * @brief HELPER - Creates the prisoners, in index order, and the switch rooms inside the arena.
+ *
+ * @details With more than one room, the prisoners are dealt out to the rooms as described in rooms.h, and
+ * each room's switch starts in a position of its own. Under the process warden, each room gets a lock that
+ * works across processes, and the challenge gets its gate.
+ */
+void Prison::populate()
+{
+    int32_t pid = Global::PID;
+    uint32_t number_of_prisoners = Prison::total_number_of_prisoners;
+    uint32_t number_of_rooms = Parser::get_rooms();
+
+    // generate number_of_prisoners Prisoner objects
+    if (Parser::debug_is_on()) {
+        std::cout << "==" << pid << "== Creating " << number_of_prisoners << " Prisoner objects (" <<
+            number_of_prisoners - number_of_rooms << " Setters, ";
+        if (number_of_rooms > 1) std::cout << number_of_rooms - 1 << " Relays, ";
+        std::cout << "1 Resetter)." << std::endl;
+    }
+    for (uint32_t index = 1; index < number_of_prisoners; index++) {
+        uint32_t room = Rooms::room_of(index, number_of_prisoners, number_of_rooms);
+        if (Rooms::is_relay(index, number_of_prisoners, number_of_rooms))
+            Prison::prisoners.push_back(Prison::arena->create<Relay>(index, room,
+                Rooms::size_of(room, number_of_prisoners, number_of_rooms) - 1));
+        else Prison::prisoners.push_back(Prison::arena->create<Setter>(index, room));
     }
-    delete Prison::switch_room;
-    delete Prison::mt;
+    Prison::prisoners.push_back(Prison::arena->create<Resetter>(number_of_prisoners, 0u,
+        Rooms::size_of(0, number_of_prisoners, number_of_rooms) - 1 + number_of_rooms - 1));
+
+    // initialize switch rooms
+    for (uint32_t room = 0; room < number_of_rooms; room++) {
+        switch_state initial_state = Parser::get_initial_switch_state();
+        uint8_t initial_position = initial_state == switch_state::on ? RoomSwitch::TOP : 0;
+        if (initial_state == switch_state::unknown) {
+            std::uniform_int_distribution<uint8_t> distribution(0, RoomSwitch::TOP);
+            initial_position = distribution(*Prison::mt);
+        }
+        if (Parser::debug_is_on()) {
+            std::cout << "==" << pid << "== Creating switch room ";
+            if (number_of_rooms > 1) std::cout << room << " ";
+            std::cout << "in initial position ";
+            if (Global::POSITIONS == 2) std::cout << (initial_position > 0 ? "on." : "off.") << std::endl;
+            else std::cout << +initial_position << "." << std::endl;
+        }
+        Prison::rooms.push_back(Prison::arena->create<SwitchRoom>(initial_position,
+            Rooms::size_of(room, number_of_prisoners, number_of_rooms)));
+        if (room == 0) Prison::result.started_on = initial_position > 0;
+    }
+    if (number_of_rooms > 1) {      // numbers the entries into every room, so coverage counts all of them
+        std::atomic<uint64_t>* sequence = Prison::arena->create<std::atomic<uint64_t>>(uint64_t{0});
+        for (SwitchRoom* room : Prison::rooms) room->set_sequence(sequence);
+    }
+    for (uint32_t room = 1; room < number_of_rooms; room++)  // the relays come right before the resetter
+        static_cast<Relay*>(Prison::prisoners.at(number_of_prisoners - 1 - room))->set_chief_room(
+            Prison::rooms.front());
+    if (Parser::get_warden() == warden::handoff) {
+        Prison::handoff_control = Prison::arena->create<Handoff>(number_of_prisoners,
+            Parser::get_handoff_policy(), static_cast<uint32_t>((*Prison::mt)()));
+        Prison::rooms.front()->set_handoff(Prison::handoff_control);
+    }
+    if (Parser::get_warden() == warden::process) {
+        Prison::process_control = Prison::arena->create<Processes>();
+        for (SwitchRoom* room : Prison::rooms) room->set_process_key(Prison::arena->create<ProcessKey>());
+    }
+}
+
+/**
+ * @brief HELPER - Throws away everything populate() created, rewinding the arena to just after the Twister.
+ */
+void Prison::clear()
+{
+    if (Prison::handoff_control != nullptr) Prison::handoff_control->~Handoff();
+    Prison::handoff_control = nullptr;
+    Prison::process_control = nullptr;
+    Prison::rooms.clear();
+    Prison::prisoners.clear();
+    Prison::arena->rewind(Prison::arena_mark);
+}
+
+/**
+ * @brief HELPER - Has a prisoner visit their switch room, for the wardens that pick who goes next.
+ *
+ * @param idx Position of the prisoner in the prison's vector, which may have been shuffled.
+ * @param challenge_finished Set to true once a prisoner thinks they have won.
+ */
+void Prison::visit(uint32_t idx, bool* challenge_finished)
+{
+    Prisoner* prisoner = Prison::prisoners.at(idx);
+    prisoner->perform_task(challenge_finished, Prison::rooms[prisoner->get_room()]);
 }
 
 /**
@@ -108,6 +311,17 @@ uint8_t Prison::prisoner_id_len()
     return Prison::prisoner_unique_index_len;
 }
 
+/**
+ * @brief GETTER - Interface for getting whether prisoners run in their own threads or processes.
+ *
+ * @return Returns true when the warden is os, handoff, or process, false for the single threaded wardens.
+ */
+bool Prison::is_threaded()
+{
+    warden w = Parser::get_warden();
+    return w == warden::os || w == warden::handoff || w == warden::process;
+}
+
 /**
  * @brief SUB METHOD - This should be called by the main method.
  * 
@@ -115,10 +329,14 @@ uint8_t Prison::prisoner_id_len()
  * This method serves as the interface to start the simulation running.
  * This method starts threads for each prisoner, then immediately attempts to join them. They won't actually
  * join until one of the prisoners declares that the challenge is complete. At that point, this method will
- * check that all prisoners have actually in fact visited the room.
+ * check that all prisoners have actually in fact visited the room. Unless the start mode is free, every
+ * thread first parks at a start gate, and the timer only starts once they have all been released. The
+ * process warden does the same with a process for each prisoner instead of a thread.
  * 
  * @return Returns true when the prisoners succeed at the challenge, false if they fail.
  * @throws std::logic_error When init() hasn't been called first.
+ * @throws std::runtime_error When the prisoner threads or processes can't all be started, or a prisoner
+ * process dies.
  */
 bool Prison::challenge()
 {
@@ -130,60 +348,234 @@ bool Prison::challenge()
     if (d) std::cout << "==" << Global::PID << "== In Prison::challenge()." << std::endl << std::endl;
 
     bool challenge_finished = false;
+    double virtual_days = 0.0;  // only advanced by the event warden
+    uint64_t cfs_slices = 0;    // only counted by the cfs warden
+    uint64_t cfs_clock = 0;     // only advanced by the cfs warden
+    uint32_t pool_threads = 0;  // only used by the coro warden, like the counts below
+    uint64_t resumes = 0;
+    uint64_t steals = 0;
+    uint64_t handoffs = 0;
+    uint64_t walk_ins = 0;
+    double parked_seconds = 0.0;    // only added up by the os and handoff wardens, whose threads can park
+    Prison::result.weight = 1.0;    // only changed by importance sampling
 
-    // shuffle for randomness unless warden is seq or fast
-    if (w < warden::seq) std::shuffle(Prison::prisoners.begin(), Prison::prisoners.end(), *Prison::mt);
+    // the resetter is still last, since the prisoners are only shuffled below
+    if (Parser::progress_is_on()) Progress::begin(Prison::total_number_of_prisoners,
+        static_cast<Resetter*>(Prison::prisoners.back())->get_target_count());
+
+    // shuffle for randomness unless warden is seq or fast, or weighted (where the weights follow the index)
+    Timing::begin(phase::ph_spawn);
+    if (w < warden::seq || w == warden::handoff || w == warden::cfs || w == warden::process ||
+        w == warden::coro)
+        std::shuffle(Prison::prisoners.begin(), Prison::prisoners.end(), *Prison::mt);
 
     if (Parser::get_output_mode() != out_mode::silent)
         std::cout << "The challenge is commencing now!" << std::endl;
+    if (Parser::counters_are_on()) Counters::start();
+    double cpu_start = Counters::process_cpu_seconds();
     auto start = std::chrono::high_resolution_clock::now();
 
     // start every prisoner on their task
-    if (w == warden::os) {
-        std::vector<std::thread> threads;
+    if (!Prison::is_threaded() && w != warden::coro) {
+        Timing::end(phase::ph_spawn);
+        Timing::begin(phase::ph_contest);
+    }
+    if (w == warden::process) {
+        start_mode s_m = Parser::get_start_mode();
+        bool gated = s_m != start_mode::s_free;
+        bool pin = Parser::pin_is_on();
+        Processes* control = Prison::process_control;
+        Config quiet = Parser::get_config();    // output from every process at once would be scrambled
+        quiet.output = out_mode::silent;
+        quiet.verbose = verb_mode::v_off;
+        quiet.debug = debug_mode::d_off;
+        std::vector<pid_t> pids;
+        pids.reserve(Prison::total_number_of_prisoners);
+        uint32_t ticket = 0;
+        int32_t err = 0;
+        control->clocks.spawn_began.store(Timing::current()->spawn_began.load());  // the events count from it
         for (Prisoner* prisoner : Prison::prisoners) {
-            threads.push_back(
-                std::thread(
-                    &Prisoner::perform_task,
-                    prisoner,
-                    &challenge_finished,
-                    Prison::switch_room
-                )
+            SwitchRoom* room = Prison::rooms.at(prisoner->get_room());
+            pid_t pid = Processes::spawn([prisoner, room, ticket, gated, pin, control, &quiet]() {
+                Timing::adopt(&control->clocks);    // a forked copy of the warden's clocks would be lost
+                Timing::mark_thread_start();
+                Parser::adopt(&quiet);
+                if (ticket > 0) Threading::hush();  // the first prisoner reports what the OS refuses
+                if (pin) Threading::pin(ticket);
+                Threading::apply_scheduling(prisoner->is_resetter());
+                if (gated) control->gate_wait(ticket);
+                prisoner->perform_task(&control->finished, room);
+                if (control->finished) control->finish();  // wakes the warden, and anyone still at the gate
+            });
+            if (pid < 0) {
+                err = errno;
+                break;
+            }
+            pids.push_back(pid);
+            ticket++;
+        }
+        if (err != 0) {     // let the processes already created go straight home, then give up cleanly
+            control->finish();
+            Processes::reap(pids, control);
+            Timing::end(phase::ph_spawn);
+            throw std::runtime_error("Could only start " + std::to_string(ticket) + " of " +
+                std::to_string(Prison::total_number_of_prisoners) + " prisoner processes (" +
+                std::strerror(err) + ")");
+        }
+        if (gated) control->gate_await(ticket);     // everyone is waiting, so nobody has a head start
+        Timing::end(phase::ph_spawn);
+        Timing::begin(phase::ph_contest);
+        if (gated) {
+            start = std::chrono::high_resolution_clock::now();
+            control->gate_release(ticket, s_m == start_mode::s_stagger ? Parser::get_stagger() : 0);
+        }
+        std::string failure = Processes::reap(pids, control);  // returns once every process has exited
+        Timing::absorb(control->clocks);            // brings home the events the prisoners marked
+        if (!failure.empty()) {
+            Timing::end(phase::ph_contest);
+            throw std::runtime_error(failure);
+        }
+        challenge_finished = control->finished;
+    } else if (Prison::is_threaded()) {
+        start_mode s_m = Parser::get_start_mode();
+        bool gated = s_m != start_mode::s_free;
+        bool pin = Parser::pin_is_on();
+        size_t stack = Parser::get_stack_size();
+        std::string limit;
+        uint64_t capacity = Threading::thread_capacity(stack, &limit);
+        if (Prison::total_number_of_prisoners > capacity) {
+            Timing::end(phase::ph_spawn);
+            throw std::runtime_error("Can't start " + std::to_string(Prison::total_number_of_prisoners) +
+                " prisoner threads; " + limit + " leaves room for about " + std::to_string(capacity));
+        }
+        std::vector<pthread_t> threads(Prison::total_number_of_prisoners);
+        std::vector<std::function<void()>> tasks;  // reserved, so each stays put while its thread runs it
+        tasks.reserve(Prison::total_number_of_prisoners);
+        uint32_t ticket = 0;
+        int32_t err = 0;
+        const Config* config = &Parser::get_config();
+        Timing::Clocks* clocks = Timing::current();
+        Threading::Gates gates;
+        Threading::Gates* outer = Threading::adopt(&gates);
+        for (Prisoner* prisoner : Prison::prisoners) {
+            SwitchRoom* room = Prison::rooms.at(prisoner->get_room());  // the prison is per thread
+            tasks.push_back(
+                [prisoner, room, ticket, gated, pin, config, clocks, &gates, &challenge_finished]() {
+                    Parser::adopt(config);
+                    Timing::adopt(clocks);
+                    Threading::adopt(&gates);
+                    Timing::mark_thread_start();
+                    TRACE_THREAD(prisoner->to_string());
+                    TRACE_BEGIN("prisoner thread");
+                    if (pin) Threading::pin(ticket);
+                    Threading::apply_scheduling(prisoner->is_resetter());
+                    TRACE_BEGIN("at the start gate");
+                    if (gated) Threading::gate_wait(ticket);
+                    TRACE_END("at the start gate");
+                    prisoner->perform_task(&challenge_finished, room);
+                    TRACE_END("prisoner thread");
+                }
             );
+            err = Threading::spawn(&threads.at(ticket), &tasks.back(), stack);
+            if (err != 0) break;
+            ticket++;
+        }
+        if (err != 0) {     // let the threads already created go straight home, then give up cleanly
+            challenge_finished = true;
+            Threading::gate_release(ticket, 0);
+            Threading::park_release();
+            for (uint32_t idx = 0; idx < ticket; idx++) pthread_join(threads.at(idx), nullptr);
+            Threading::adopt(outer);
+            Timing::end(phase::ph_spawn);
+            throw std::runtime_error("Could only start " + std::to_string(ticket) + " of " +
+                std::to_string(Prison::total_number_of_prisoners) + " prisoner threads (" +
+                std::strerror(err) + ")");
         }
-        for (std::thread& thread : threads) {
-            thread.join();  // only happens once a prisoner declares that the challenge is over
+        if (gated) Threading::gate_await(ticket);   // everyone is parked, so nobody has a head start
+        Timing::end(phase::ph_spawn);
+        Timing::begin(phase::ph_contest);
+        if (gated) {
+            start = std::chrono::high_resolution_clock::now();
+            Threading::gate_release(ticket, s_m == start_mode::s_stagger ? Parser::get_stagger() : 0);
         }
+        for (pthread_t thread : threads) {
+            pthread_join(thread, nullptr);  // only happens once a prisoner declares the challenge over
+        }
+        parked_seconds = static_cast<double>(gates.parked_ns) / 1e9;
+        Threading::adopt(outer);
+    } else if (w == warden::coro) {
+        Coroutines pool(Prison::prisoners, Prison::rooms.front(), &challenge_finished,
+            Parser::get_pool_size(), Parser::get_handoff_policy(), static_cast<uint32_t>((*Prison::mt)()));
+        Timing::end(phase::ph_spawn);
+        Timing::begin(phase::ph_contest);
+        start = std::chrono::high_resolution_clock::now();     // creating the coroutines doesn't count
+        try {
+            pool.run();
+        } catch (...) {
+            Timing::end(phase::ph_contest);
+            throw;
+        }
+        pool_threads = pool.get_thread_count();
+        resumes = pool.get_resume_count();
+        steals = pool.get_steal_count();
+        handoffs = pool.get_handoff_count();
+        walk_ins = pool.get_walk_in_count();
+    } else if (w == warden::pseudo && Parser::importance_is_on()) {
+        BiasedPicker picker(Prison::total_number_of_prisoners, Parser::get_bias());
+        while (!challenge_finished) {
+            Prison::visit(picker.pick(*Prison::mt), &challenge_finished);
+        }
+        Prison::result.weight = picker.get_weight();
     } else if (w == warden::pseudo) {
         std::uniform_int_distribution<uint32_t> dist(0, Prison::total_number_of_prisoners - 1);
         while (!challenge_finished) {
-            Prison::prisoners.at(dist(*Prison::mt))->perform_task(
-                &challenge_finished,
-                Prison::switch_room
-            );
+            Prison::visit(dist(*Prison::mt), &challenge_finished);
+        }
+    } else if (w == warden::weighted) {
+        while (!challenge_finished) {
+            Prison::visit(Prison::alias->sample(*Prison::mt), &challenge_finished);
         }
+    } else if (w == warden::event) {
+        ArrivalClock clock(Parser::get_arrival_mode(), Parser::get_period());
+        std::vector<EventQueue::Event> first_visits;
+        first_visits.reserve(Prison::total_number_of_prisoners);
+        for (uint32_t idx = 0; idx < Prison::total_number_of_prisoners; idx++)
+            first_visits.push_back({clock.first(*Prison::mt), idx});
+        EventQueue queue(std::move(first_visits));
+        while (!challenge_finished) {
+            const EventQueue::Event& next = queue.top();
+            virtual_days = next.time;
+            Prison::visit(next.index, &challenge_finished);
+            queue.reschedule_top(virtual_days + clock.next(*Prison::mt));
+        }
+    } else if (w == warden::cfs) {
+        FairScheduler scheduler(Prison::total_number_of_prisoners, Parser::get_granularity(),
+            Parser::get_visit_cost());
+        while (!challenge_finished) {
+            uint64_t visits = 0;
+            uint64_t made = 0;
+            uint32_t idx = scheduler.pick(&visits);
+            while (made < visits && !challenge_finished) {
+                Prison::visit(idx, &challenge_finished);
+                made++;
+            }
+            scheduler.preempt(idx, made);
+        }
+        cfs_slices = scheduler.get_slice_count();
+        cfs_clock = scheduler.get_clock();
     } else if (w == warden::fixed || w == warden::seq) {
         while (!challenge_finished) {
             for (uint32_t idx = 0; idx < Prison::total_number_of_prisoners; idx++) {
-                Prison::prisoners.at(idx)->perform_task(
-                    &challenge_finished,
-                    Prison::switch_room
-                );
+                Prison::visit(idx, &challenge_finished);
                 if (challenge_finished) break;
             }
         }
     } else {    // w == warden::fast
         while (!challenge_finished) {
             for (uint32_t idx = 0; idx < Prison::total_number_of_prisoners - 1; idx++) {
-                Prison::prisoners.at(Prison::total_number_of_prisoners - 1)->perform_task(
-                    &challenge_finished,
-                    Prison::switch_room
-                );
+                Prison::visit(Prison::total_number_of_prisoners - 1, &challenge_finished);
                 if (challenge_finished) break;
-                Prison::prisoners.at(idx)->perform_task(
-                    &challenge_finished,
-                    Prison::switch_room
-                );
+                Prison::visit(idx, &challenge_finished);
                 if (challenge_finished) break;
             }
         }
@@ -191,23 +583,101 @@ bool Prison::challenge()
 
     // stop timer and output miscellaneous statistics
     auto end = std::chrono::high_resolution_clock::now();
+    Timing::end(phase::ph_contest);
     std::chrono::duration<double> duration = end - start;
+    if (Parser::counters_are_on()) Counters::stop();
+    double cpu_used = Counters::process_cpu_seconds() - cpu_start;
+
+    // add up what happened in every room; everyone had been in once the last room was covered
+    uint64_t entries = 0;
+    uint32_t flips = 0;
+    uint32_t parked = 0;
+    uint32_t recovered = 0;
+    uint64_t coverage = 0;
+    bool covered = true;
+    for (SwitchRoom* room : Prison::rooms) {
+        entries += room->get_entered_count();
+        flips += room->get_flipped_count();
+        parked += room->get_parked_count();
+        recovered += room->get_recovered_count();
+        coverage = std::max(coverage, room->get_coverage_entry());
+        covered = covered && room->get_coverage_entry() > 0;
+    }
+    size_t number_of_rooms = Prison::rooms.size();
     if (Parser::get_output_mode() != out_mode::silent) {
         std::cout << std::endl << "The challenge ended in " << duration.count() << " seconds." << std::endl;
-        std::cout << "The switch room was entered " << Prison::switch_room->get_entered_count() <<
-            " times total." << std::endl;
-        std::cout << "The switch was flipped " << Prison::switch_room->get_flipped_count() <<
-            " times total." << std::endl;
+        if (number_of_rooms == 1) {
+            std::cout << "The switch room was entered " << entries << " times total." << std::endl;
+            std::cout << "The switch was flipped " << flips << " times total." << std::endl;
+        } else {
+            std::cout << "The " << number_of_rooms << " switch rooms were entered " << entries <<
+                " times total, or " << static_cast<double>(entries) / duration.count() <<
+                " times per second." << std::endl;
+            std::cout << "The switches were flipped " << flips << " times total." << std::endl;
+        }
+        if (Prison::handoff_control != nullptr) std::cout << "The room was handed directly to a waiting " <<
+            "prisoner " << Prison::handoff_control->get_handoff_count() << " times, and found free " <<
+            Prison::handoff_control->get_walk_in_count() << " times." << std::endl;
+        if (w == warden::event) {
+            std::cout << "In virtual time, the challenge ended on day " << virtual_days << " (about " <<
+                virtual_days / 365.25 << " years)." << std::endl;
+            std::cout << "The simulator processed " << static_cast<double>(entries) / duration.count() <<
+                " events per second." << std::endl;
+        }
+        if (w == warden::coro) {
+            std::cout << "The room was handed directly to a waiting prisoner " << handoffs <<
+                " times, and found free " << walk_ins << " times." << std::endl;
+            std::cout << "The pool's " << pool_threads << " thread(s) resumed prisoners " << resumes <<
+                " times, " << steals << " of them after stealing them from another thread." << std::endl;
+        }
+        if (w == warden::cfs) std::cout << "The emulated scheduler handed out " << cfs_slices <<
+            " time slices, over " << static_cast<double>(cfs_clock) / 1e9 <<
+            " seconds of emulated CPU time." << std::endl;
+        if (Prison::is_threaded()) std::cout << "The prisoner " << (w == warden::process ? "processes" :
+            "threads") << " used " << cpu_used << " seconds of CPU time." << std::endl;
+        if (recovered > 0) std::cout << "A prisoner got into a room after the prisoner inside had died " <<
+            recovered << " times." << std::endl;
+        if (Parser::park_is_on() && w == warden::process)
+            std::cout << parked << " setters ended their process once they were done." << std::endl;
+        else if (Parser::park_is_on() && Prison::is_threaded()) {
+            std::cout << parked << " setters parked once they were done, for " << parked_seconds <<
+                " seconds in all." << std::endl;
+            std::cout << "The entries leave out the visits they would have made meanwhile, so they can't be "
+                "compared with those of a run without parking." << std::endl;
+        }
     }
+    if (Parser::counters_are_on()) Counters::print(entries);
 
     // check if all prisoners visited the room
+    Timing::begin(phase::ph_verify);
+    Prison::result.entries = entries;
+    Prison::result.flips = flips;
+    Prison::result.seconds = duration.count();
+    Prison::result.cpu_seconds = cpu_used;
+    Prison::result.coverage = covered ? coverage : 0;
+    Prison::result.success = true;
     for (Prisoner* prisoner : Prison::prisoners) {
         if (!prisoner->has_been_in_switch_room()) {
-            if (Parser::get_output_mode() != out_mode::silent)
-                std::cout << "But the claim was wrong...." << std::endl;
-            return false;
+            Prison::result.success = false;
+            break;
         }
     }
-    if (Parser::get_output_mode() != out_mode::silent) std::cout << "The claim was correct." << std::endl;
-    return true;
+    Timing::end(phase::ph_verify);
+    if (Parser::get_output_mode() != out_mode::silent)
+        std::cout << (Prison::result.success ? "The claim was correct." : "But the claim was wrong....") <<
+            std::endl;
+    return Prison::result.success;
+}
+
+/**
+ * @brief GETTER - Interface for getting what the last challenge came to, for aggregating over trials.
+ *
+ * @return Returns a reference to the result, which is overwritten by the next call to challenge().
+ * @throws std::logic_error When init() hasn't been called first.
+ */
+const ChallengeResult& Prison::last_result()
+{
+    if (!Prison::init_called) throw std::logic_error("Prison::init() must be called first");
+
+    return Prison::result;
 }
\ No newline at end of file
@@ -6,7 +6,8 @@ Isaac Jung
 |===========================================================================================================|
 */
 
-#include <iomanip>
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <thread>
 #include <unistd.h>
@@ -14,6 +15,8 @@ Isaac Jung
 #include "parser.h"
 #include "prison.h"
 #include "prisoner.h"
+#include "threading.h"
+#include "trace.h"
 
 
 /*============================================== Prisoner =================================================*/
@@ -22,23 +25,48 @@ Isaac Jung
  * @brief CONSTRUCTOR - Initializes the object.
  * 
  * @param index unique number assigned to the prisoner for easier identification purposes.
+ * @param room_number Switch room the prisoner belongs to, from 0 to the number of rooms - 1.
  */
-Prisoner::Prisoner(uint32_t index) : unique_index(index), str_rep(to_string_internal(index)) {}
+Prisoner::Prisoner(uint32_t index, uint32_t room_number) : unique_index(index), room(room_number)
+{
+    this->to_string_internal(index, "");
+}
 
 /**
  * @brief INTERNAL SETTER - Interface for setting the string representation of the prisoner.
  *
- * @details This is a private method which should be called only in the member initializer list of the class
- * constructor, to set the const value of str_rep.
+ * @details This is a protected method which should be called only in the class constructors, to set the
+ * value of str_rep. The base class calls it without a role first, which also records name_len; the child
+ * classes then call it again with their role.
  *
  * @param index unique number assigned to the prisoner for easier identification purposes.
- * @return Returns a string of the form "Prisoner #x", where x is their index buffered with 0s.
+ * @param role Text to append after the index, such as " (Setter)", or an empty string.
+ */
+void Prisoner::to_string_internal(uint32_t index, const char* role)
+{
+    int32_t len = std::snprintf(this->str_rep, sizeof(this->str_rep), "Prisoner #%0*u%s",
+        static_cast<int32_t>(Prison::prisoner_id_len()), index, role);
+    if (*role == '\0') this->name_len = static_cast<uint8_t>(len);
+}
+
+/**
+ * @brief GETTER - Interface for getting the prisoner's unique index.
+ * 
+ * @return Returns the index given at construction, from 1 to the number of prisoners.
  */
-std::string Prisoner::to_string_internal(uint32_t index) const
+uint32_t Prisoner::get_index() const
 {
-    std::stringstream ret;
-    ret << "Prisoner #" << std::setfill('0') << std::setw(Prison::prisoner_id_len()) << index;
-    return ret.str();
+    return this->unique_index;
+}
+
+/**
+ * @brief GETTER - Interface for getting the switch room this prisoner belongs to.
+ *
+ * @return Returns the room's number, 0 unless there is more than one room.
+ */
+uint32_t Prisoner::get_room() const
+{
+    return this->room;
 }
 
 /**
@@ -72,6 +100,26 @@ bool Prisoner::has_been_in_switch_room()
     return this->entered_count > 0;
 }
 
+/**
+ * @brief GETTER - Interface for getting how many times this prisoner has entered the switch room.
+ *
+ * @return Returns the count, which already includes a visit in progress.
+ */
+uint64_t Prisoner::get_entered_count() const
+{
+    return this->entered_count;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times this prisoner has flipped the switch.
+ *
+ * @return Returns an integer greater than or equal to 0.
+ */
+uint32_t Prisoner::get_flip_count() const
+{
+    return this->flip_count;
+}
+
 /**
  * @brief HELPER - Prints message and sets the flag that tells everyone that the challenge is over.
  * 
@@ -81,10 +129,12 @@ void Prisoner::declare_completion(bool* challenge_finished)
 {
     if (Parser::get_output_mode() != out_mode::silent) {
         Global::output_mutex.lock();
-        std::cout << std::endl << this->str_rep << " declares that the challenge is complete!" << std::endl;
+        std::cout << std::endl << std::string(this->str_rep, this->name_len) <<
+            " declares that the challenge is complete!" << std::endl;
         Global::output_mutex.unlock();
     }
     *challenge_finished = true;
+    Threading::park_release();
 }
 
 
@@ -94,8 +144,12 @@ void Prisoner::declare_completion(bool* challenge_finished)
  * @brief CONSTRUCTOR - Initializes the object.
  * 
  * @param index unique number assigned to the prisoner for easier identification purposes.
+ * @param room_number Switch room the setter belongs to.
  */
-Setter::Setter(uint32_t index) : Prisoner(index), str_rep(to_string_internal(index)) {}
+Setter::Setter(uint32_t index, uint32_t room_number) : Prisoner(index, room_number)
+{
+    this->to_string_internal(index, " (Setter)");
+}
 
 /**
  * @brief DECONSTRUCTOR - Frees memory.
@@ -103,27 +157,23 @@ Setter::Setter(uint32_t index) : Prisoner(index), str_rep(to_string_internal(ind
 Setter::~Setter() {}
 
 /**
- * @brief INTERNAL SETTER - Interface for setting the string representation of the setter.
+ * @brief GETTER - Interface for getting the string representation of the setter.
  * 
- * @details This is a private method which should be called only in the member initializer list of the class
- * constructor, to set the const value of str_rep.
- *
- * @param index unique number assigned to the prisoner for easier identification purposes.
  * @return Returns a string of the form "Prisoner #x (Setter)", where x is their index buffered with 0s.
  */
-std::string Setter::to_string_internal(uint32_t index) const
+std::string Setter::to_string() const
 {
-    return Prisoner::to_string_internal(index) + " (Setter)";
+    return this->str_rep;
 }
 
 /**
- * @brief GETTER - Interface for getting the string representation of the setter.
+ * @brief GETTER - Interface for getting whether this prisoner is the resetter.
  * 
- * @return Returns the str_rep built by to_string_internal() during object construction.
+ * @return Returns false, since this prisoner is a setter.
  */
-std::string Setter::to_string() const
+bool Setter::is_resetter() const
 {
-    return this->str_rep;
+    return false;
 }
 
 /**
@@ -131,7 +181,9 @@ std::string Setter::to_string() const
  * 
  * The prison will have every prisoner attempt to carry out their tasks concurrently.
  * Setters want to enter the room and flip the switch to the on state if they can. They want to do this
- * exactly two times, and then never flip the switch again.
+ * exactly two times, and then never flip the switch again. When the switch has more than two positions, they
+ * instead turn it up as far as it goes each time, until they have turned it up as many steps as it has
+ * positions.
  * This method serves as the loop logic that a setter will follow to attempt to carry this out.
  * 
  * @param challenge_finished Starts false, and gets set to true when a prisoner thinks they have won.
@@ -161,24 +213,29 @@ void Setter::perform_task(bool* challenge_finished, SwitchRoom *switch_room)
             Global::output_mutex.unlock();
         }
 
-        // if this prisoner has already flipped the switch up twice, they should just leave immediately
+        // if this prisoner has already turned the switch up as far as they want, they should just leave
         if (this->flip_count >= this->target_count) {
             switch_room->exit(this, "leave without doing anything (because they are done)");
         }
 
-        // check the state of the switch; if it's currently on, leave immediately
-        switch_state current_state = switch_room->check_switch(this);
-        if (current_state == switch_state::on)
-            switch_room->exit(this, "leave without doing anything (because the switch is on)");
-
-        // if the switch is currently off, turn it on
-        else if (current_state == switch_state::off) {
-            switch_room->flip_switch(this);
-            this->flip_count++;
+        // check the position of the switch; if it can't be turned up any further, leave immediately
+        uint8_t position = 0;
+        bool inside = switch_room->check_switch(this, &position);  // false if they have already left
+        if (inside && position == RoomSwitch::TOP)
+            switch_room->exit(this, Global::POSITIONS == 2 ? "leave without doing anything (because the "
+                "switch is on)" : "leave without doing anything (because the switch is all the way up)");
+
+        // otherwise, turn it up as far as it goes, or as far as they still want to
+        else if (inside) {
+            uint8_t to = static_cast<uint8_t>(std::min<uint32_t>(RoomSwitch::TOP,
+                position + this->target_count - this->flip_count));
+            switch_room->turn_switch(this, to);
+            this->flip_count += static_cast<uint32_t>(to - position);
             if (Parser::verbose_is_on()) {
                 Global::output_mutex.lock();
-                std::cout << "  --> They have now flipped the switch " << this->flip_count << " time(s)." <<
-                    std::endl;
+                std::cout << "  --> They have now " << (Global::POSITIONS == 2 ? "flipped the switch " :
+                    "turned the switch up ") << this->flip_count << (Global::POSITIONS == 2 ? " time(s)." :
+                    " step(s).") << std::endl;
                 Global::output_mutex.unlock();
             }
             switch_room->exit(this);
@@ -188,15 +245,34 @@ void Setter::perform_task(bool* challenge_finished, SwitchRoom *switch_room)
         if (Parser::get_strategy() == strategy::improper && this->entered_count > Setter::target_count
                 && this->flip_count >= Setter::target_count) this->declare_completion(challenge_finished);
 
+        // once done, a setter using the proper strategy can never matter again, so they may park instead
+        bool parking = Prison::is_threaded() && Parser::park_is_on() &&
+            Parser::get_strategy() == strategy::proper && this->flip_count >= this->target_count;
+        if (parking) switch_room->park(this);
+
         // lock the switch room so that the next prisoner may unlock it
         switch_room->lock(this);
-        if (Parser::get_warden() != warden::os) break;
+        if (!Prison::is_threaded()) break;
+        if (parking && Parser::get_warden() == warden::process) break;    // a process just ends instead
+        if (parking) {
+            if (Parser::debug_is_on()) {
+                Global::output_mutex.lock();
+                std::cout << "==" << tid << "== Parking until the challenge is over." << std::endl;
+                Global::output_mutex.unlock();
+            }
+            TRACE_BEGIN("parked");
+            Threading::park_wait();
+            TRACE_END("parked");
+            continue;
+        }
         if (Parser::debug_is_on()) {
             Global::output_mutex.lock();
             std::cout << "==" << tid << "== Sleeping for " << Global::WAIT_TIME << " seconds." << std::endl;
             Global::output_mutex.unlock();
         }
+        TRACE_BEGIN("backing off");
         sleep(Global::WAIT_TIME);
+        TRACE_END("backing off");
         if (Parser::debug_is_on()) {
             Global::output_mutex.lock();
             std::cout << "==" << tid << "== Woke up." << std::endl;
@@ -211,9 +287,17 @@ void Setter::perform_task(bool* challenge_finished, SwitchRoom *switch_room)
  * @brief CONSTRUCTOR - Initializes the object.
  * 
  * @param index unique number assigned to the prisoner for easier identification purposes.
+ * @param room_number Switch room the resetter counts in; the resetter of room 0 is the chief, the others are
+ *  relays.
+ * @param counted Number of other prisoners whose flips the resetter counts in that room.
  */
-Resetter::Resetter(uint32_t index) : Prisoner(index), target_count(calculate_target_count()),
-    str_rep(to_string_internal(index)) {}
+Resetter::Resetter(uint32_t index, uint32_t room_number, uint32_t counted) : Prisoner(index, room_number),
+    target_count(calculate_target_count(counted))
+{
+    this->to_string_internal(index, " (Resetter)");
+    if (room_number == 0 && Parser::debug_is_on()) std::cout << "==" << Global::PID <<
+        "== Calculated Resetter target count as: " << this->target_count << std::endl;
+}
 
 /**
  * @brief DECONSTRUCTOR - Frees memory.
@@ -221,27 +305,33 @@ Resetter::Resetter(uint32_t index) : Prisoner(index), target_count(calculate_tar
 Resetter::~Resetter() {}
 
 /**
- * @brief INTERNAL SETTER - Interface for setting the string representation of the resetter.
+ * @brief GETTER - Interface for getting the string representation of the resetter.
  * 
- * @details This is a private method which should be called only in the member initializer list of the class
- * constructor, to set the const value of str_rep.
- *
- * @param index unique number assigned to the prisoner for easier identification purposes.
  * @return Returns a string of the form "Prisoner #x (Resetter)", where x is their index buffered with 0s.
  */
-std::string Resetter::to_string_internal(uint32_t index) const
+std::string Resetter::to_string() const
 {
-    return Prisoner::to_string_internal(index) + " (Resetter)";
+    return this->str_rep;
 }
 
 /**
- * @brief GETTER - Interface for getting the string representation of the resetter.
+ * @brief GETTER - Interface for getting whether this prisoner is the resetter.
  * 
- * @return Returns the str_rep built by to_string_internal() during object construction.
+ * @return Returns true, since this prisoner is the resetter.
  */
-std::string Resetter::to_string() const
+bool Resetter::is_resetter() const
 {
-    return this->str_rep;
+    return true;
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times the resetter means to turn the switch off.
+ *
+ * @return Returns the target count calculated at construction.
+ */
+uint64_t Resetter::get_target_count() const
+{
+    return this->target_count;
 }
 
 /**
@@ -250,14 +340,24 @@ std::string Resetter::to_string() const
  * @details This is a private method which should be called only in the member initializer list of the class
  * constructor, to set the const value of target_count.
  *
- * @return Returns a string of the form "Prisoner #x (Resetter)", where x is their index buffered with 0s.
+ * @param counted Number of prisoners whose flips are counted, each of whom turns the switch up as many steps
+ *  as it has positions (flipping it on twice, for the usual switch).
+ * @return Returns the number of steps the switch must be turned back down, one per flip off for 2 positions.
  */
-uint64_t Resetter::calculate_target_count() const
+uint64_t Resetter::calculate_target_count(uint32_t counted)
 {
-    uint64_t ret = (Prison::num_prisoners() - (Global::SETTER_MAX_COUNT - 1)) * Global::SETTER_MAX_COUNT;
-    if (Parser::debug_is_on())
-        std::cout << "==" << Global::PID << "== Calculated Resetter target count as: " << ret << std::endl;
-    return ret;
+    return static_cast<uint64_t>(counted) * Global::SETTER_MAX_COUNT;
+}
+
+/**
+ * @brief HELPER - Called once the target count is reached; the chief resetter declares completion.
+ *
+ * @param challenge_finished Should be false when passed to this method, but will be set to true.
+ */
+void Resetter::finish_counting(bool* challenge_finished)
+{
+    this->done_counting = true;
+    this->declare_completion(challenge_finished);
 }
 
 /**
@@ -275,7 +375,7 @@ uint64_t Resetter::calculate_target_count() const
 void Resetter::perform_task(bool *challenge_finished, SwitchRoom *switch_room)
 {
     std::thread::id tid = std::this_thread::get_id();
-    while (!*challenge_finished) {
+    while (!*challenge_finished && !this->done_counting) {
         // try to unlock the switch room
         switch_room->unlock(this);
         if (*challenge_finished) {  // it's possible this changed while this prisoner was waiting to enter
@@ -295,46 +395,51 @@ void Resetter::perform_task(bool *challenge_finished, SwitchRoom *switch_room)
             Global::output_mutex.unlock();
         }
 
-        // check the state of the switch; if it's currently off, leave immediately
-        switch_state current_state = switch_room->check_switch(this);
-        if (current_state == switch_state::off) {
+        // check the position of the switch; if it's currently off, leave immediately
+        uint8_t position = 0;
+        bool inside = switch_room->check_switch(this, &position);  // false if they have already left
+        if (inside && position == 0) {
             if (this->entered_count == 1) this->switch_start_state = switch_state::off;
             switch_room->exit(this, "leave without doing anything (because the switch is off)");
             if (Parser::verbose_is_on()) {
                 Global::output_mutex.lock();
-                std::cout << "  --> They note that they only have to count to " << this->target_count - 1 <<
-                    " now!" << std::endl;
+                std::cout << "  --> They note that they only have to count to " <<
+                    this->target_count - RoomSwitch::TOP << " now!" << std::endl;
                 Global::output_mutex.unlock();
             }
         }
 
-        // if the switch is currently on, turn it off
-        else if (current_state == switch_state::on) {
-            switch_room->flip_switch(this);
-            this->flip_count++;
+        // otherwise, turn it off, counting every step it was turned up
+        else if (inside) {
+            switch_room->turn_switch(this, 0);
+            this->flip_count += position;
             if (Parser::verbose_is_on()) {
                 Global::output_mutex.lock();
-                std::cout << "  --> They have now flipped the switch " << this->flip_count << " time(s)." <<
-                    std::endl;
+                std::cout << "  --> They have now " << (Global::POSITIONS == 2 ? "flipped the switch " :
+                    "counted ") << this->flip_count << (Global::POSITIONS == 2 ? " time(s)." :
+                    " step(s).") << std::endl;
                 Global::output_mutex.unlock();
             }
             switch_room->exit(this);
         }
 
-        // can declare challenge complete if they just counted the final setter
-        if (this->flip_count >= this->target_count - (
-                (this->switch_start_state == switch_state::off && this->target_count > 0) ? 1 : 0))
-            this->declare_completion(challenge_finished);
+        // can declare challenge complete if they just counted the final setter; when the switch is known to
+        // have started off, none of the steps counted are left over from the start, so they need fewer
+        if (this->flip_count >= this->target_count - ((this->switch_start_state == switch_state::off &&
+                this->target_count > 0) ? RoomSwitch::TOP : 0))
+            this->finish_counting(challenge_finished);
 
         // lock the switch room so that the next prisoner may unlock it
         switch_room->lock(this);
-        if (Parser::get_warden() != warden::os) break;
+        if (!Prison::is_threaded()) break;
         if (Parser::debug_is_on()) {
             Global::output_mutex.lock();
             std::cout << "==" << tid << "== Sleeping for " << Global::WAIT_TIME << " seconds." << std::endl;
             Global::output_mutex.unlock();
         }
+        TRACE_BEGIN("backing off");
         sleep(Global::WAIT_TIME);
+        TRACE_END("backing off");
         if (Parser::debug_is_on()) {
             Global::output_mutex.lock();
             std::cout << "==" << tid << "== Woke up." << std::endl;
@@ -0,0 +1,311 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for processes.h.                                                 |
+|===========================================================================================================|
+*/
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include "processes.h"
+
+// the prisoners mark their events in clocks shared between processes, which only works without a lock
+static_assert(std::atomic<int64_t>::is_always_lock_free, "Timing::Clocks must be lock free to be shared");
+
+
+/*============================================= ProcessKey ================================================*/
+
+/**
+ * @brief CONSTRUCTOR - Initializes the lock, which must already be in memory shared between processes.
+ *
+ * @throws std::runtime_error When the OS won't create a robust, process shared mutex.
+ */
+ProcessKey::ProcessKey()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int32_t err = pthread_mutex_init(&this->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (err != 0) throw std::runtime_error("Could not create a lock shared between processes (" +
+        std::string(std::strerror(err)) + ")");
+}
+
+/**
+ * @brief DECONSTRUCTOR - Destroys the lock, which nobody may hold anymore.
+ */
+ProcessKey::~ProcessKey()
+{
+    pthread_mutex_destroy(&this->mutex);
+}
+
+/**
+ * @brief SEMAPHORE - Waits for the lock and takes it.
+ *
+ * @details If the process holding the lock died, the lock is handed to the caller anyway and marked usable
+ * again, so that the rest of the prisoners can still get in (and find out the challenge was called off).
+ *
+ * @throws std::runtime_error When the lock can't be taken at all.
+ */
+void ProcessKey::lock()
+{
+    int32_t err = pthread_mutex_lock(&this->mutex);
+    if (err == EOWNERDEAD) {
+        pthread_mutex_consistent(&this->mutex);
+        this->recovered_count++;
+    } else if (err != 0) throw std::runtime_error("Could not lock a switch room (" +
+        std::string(std::strerror(err)) + ")");
+}
+
+/**
+ * @brief SEMAPHORE - Gives the lock back.
+ */
+void ProcessKey::unlock()
+{
+    pthread_mutex_unlock(&this->mutex);
+}
+
+/**
+ * @brief GETTER - Interface for getting how many times the lock was taken over from a process that died.
+ *
+ * @return Returns an integer greater than or equal to 0.
+ */
+uint32_t ProcessKey::get_recovered_count() const
+{
+    return this->recovered_count;
+}
+
+
+/*============================================== Processes ================================================*/
+
+/**
+ * @brief CONSTRUCTOR - Initializes the gate, closed; it must already be in memory shared between processes.
+ *
+ * @throws std::runtime_error When the OS won't create a process shared mutex and condition variable.
+ */
+Processes::Processes()
+{
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+    int32_t err = pthread_mutex_init(&this->mutex, &mutex_attr);
+    pthread_mutexattr_destroy(&mutex_attr);
+    if (err != 0) throw std::runtime_error("Could not create a lock shared between processes (" +
+        std::string(std::strerror(err)) + ")");
+
+    pthread_condattr_t cv_attr;
+    pthread_condattr_init(&cv_attr);
+    pthread_condattr_setpshared(&cv_attr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&cv_attr, CLOCK_MONOTONIC);
+    err = pthread_cond_init(&this->cv, &cv_attr);
+    pthread_condattr_destroy(&cv_attr);
+    if (err != 0) {
+        pthread_mutex_destroy(&this->mutex);
+        throw std::runtime_error("Could not create a condition variable shared between processes (" +
+            std::string(std::strerror(err)) + ")");
+    }
+}
+
+/**
+ * @brief DECONSTRUCTOR - Destroys the gate, which no process may be using anymore.
+ */
+Processes::~Processes()
+{
+    pthread_cond_destroy(&this->cv);
+    pthread_mutex_destroy(&this->mutex);
+}
+
+/**
+ * @brief HELPER - Takes the gate's lock, taking it over if the process holding it died.
+ */
+void Processes::acquire()
+{
+    if (pthread_mutex_lock(&this->mutex) == EOWNERDEAD) pthread_mutex_consistent(&this->mutex);
+}
+
+/**
+ * @brief HELPER - Waits on the condition variable; the gate's lock must be held, and is held again after.
+ *
+ * @param until Monotonic time at which to stop waiting, or nullptr to wait until woken.
+ */
+void Processes::wait(const timespec* until)
+{
+    int32_t err = until == nullptr ? pthread_cond_wait(&this->cv, &this->mutex) :
+        pthread_cond_timedwait(&this->cv, &this->mutex, until);
+    if (err == EOWNERDEAD) pthread_mutex_consistent(&this->mutex);
+}
+
+/**
+ * @brief SEMAPHORE - A prisoner process calls this to wait at the start gate until its ticket is released.
+ *
+ * @param ticket Creation order of the calling process, from 0 to the number of processes - 1.
+ */
+void Processes::gate_wait(uint32_t ticket)
+{
+    this->acquire();
+    this->arrived++;
+    pthread_cond_broadcast(&this->cv);
+    while (this->released <= ticket && !this->over) this->wait();
+    pthread_mutex_unlock(&this->mutex);
+}
+
+/**
+ * @brief SEMAPHORE - The warden calls this to wait until every prisoner process is waiting at the gate.
+ *
+ * @param count Number of processes that were created.
+ */
+void Processes::gate_await(uint32_t count)
+{
+    this->acquire();
+    while (this->arrived < count && !this->over) this->wait();
+    pthread_mutex_unlock(&this->mutex);
+}
+
+/**
+ * @brief SEMAPHORE - The warden calls this to let the waiting prisoner processes go.
+ *
+ * @param count Number of processes that were created.
+ * @param stagger Microseconds to wait between releasing consecutive tickets; 0 or less releases everyone at
+ *  once.
+ */
+void Processes::gate_release(uint32_t count, int32_t stagger)
+{
+    for (uint32_t ticket = stagger > 0 ? 1 : count; ticket <= count; ticket++) {
+        this->acquire();
+        this->released = ticket;
+        pthread_cond_broadcast(&this->cv);
+        pthread_mutex_unlock(&this->mutex);
+        if (ticket < count) std::this_thread::sleep_for(std::chrono::microseconds(stagger));
+    }
+}
+
+/**
+ * @brief SETTER - Ends the challenge for every process: the prisoners stop, and the warden is woken.
+ *
+ * @details The prisoner who declares the challenge over calls this once they are out of the room; the
+ * warden calls it to call the challenge off. Anyone still at the start gate is let through.
+ */
+void Processes::finish()
+{
+    this->acquire();
+    this->finished = true;
+    this->over = true;
+    pthread_cond_broadcast(&this->cv);
+    pthread_mutex_unlock(&this->mutex);
+}
+
+/**
+ * @brief SEMAPHORE - The warden calls this to wait for the challenge to end, for a while at most.
+ *
+ * @param ms Most milliseconds to wait.
+ * @return Returns true once finish() has been called, false if the time ran out first.
+ */
+bool Processes::await_finish(uint32_t ms)
+{
+    timespec until;
+    clock_gettime(CLOCK_MONOTONIC, &until);
+    until.tv_sec += static_cast<time_t>(ms / 1000);
+    until.tv_nsec += static_cast<long>(ms % 1000) * 1000000L;
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+    this->acquire();
+    while (!this->over) {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > until.tv_sec || (now.tv_sec == until.tv_sec && now.tv_nsec >= until.tv_nsec)) break;
+        this->wait(&until);
+    }
+    bool ended = this->over;
+    pthread_mutex_unlock(&this->mutex);
+    return ended;
+}
+
+/**
+ * @brief SUB METHOD - Forks a prisoner process, which runs a task and then exits.
+ *
+ * @details Buffered output is flushed first, so that the child doesn't print it a second time. The child
+ * never returns from this method: it exits with code 0 once the task is done, or 2 if the task threw, and
+ * is killed if the process that forked it goes away first, so no prisoner is ever left behind.
+ *
+ * @param task What the prisoner process should do.
+ * @return Returns the new process's ID, or -1 (with errno set) when it couldn't be created.
+ */
+pid_t Processes::spawn(const std::function<void()>& task)
+{
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t parent = getpid();
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent) _exit(2);   // the warden went away before the line above took effect
+    int32_t code = 0;
+    try {
+        task();
+    } catch (const std::exception& e) {
+        std::cerr << "Error in prisoner process " << getpid() << ": " << e.what() << std::endl;
+        code = 2;
+    }
+    std::cout.flush();
+    _exit(code);
+}
+
+/**
+ * @brief SUB METHOD - Waits for every prisoner process to exit, calling the challenge off if one dies.
+ *
+ * @details Until the challenge is over, the warden looks in on the prisoners every LOOK_IN_MS milliseconds,
+ * since a prisoner that was killed or crashed can keep the challenge from ever ending (if it was the
+ * resetter, or a setter who never got in). Finished setters that parked exit normally before the end, which
+ * is fine. Once the challenge is over, every remaining process is simply waited for.
+ *
+ * @param pids Every prisoner process that was created.
+ * @param control The challenge's gate.
+ * @return Returns a description of the first prisoner process that didn't exit normally, or an empty string
+ *  when they all did.
+ */
+std::string Processes::reap(const std::vector<pid_t>& pids, Processes* control)
+{
+    std::string failure;
+    std::vector<bool> reaped(pids.size(), false);
+    size_t left = pids.size();
+    auto check = [&](size_t idx, int32_t status) {
+        reaped.at(idx) = true;
+        left--;
+        if (!failure.empty() || (WIFEXITED(status) && WEXITSTATUS(status) == 0)) return;
+        failure = "Prisoner process " + std::to_string(pids.at(idx)) + (WIFSIGNALED(status) ?
+            " was killed by signal " + std::to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) +
+            ")" : " exited with code " + std::to_string(WEXITSTATUS(status)));
+    };
+
+    while (left > 0 && !control->await_finish(Processes::LOOK_IN_MS)) {
+        for (size_t idx = 0; idx < pids.size(); idx++) {
+            int32_t status = 0;
+            if (reaped.at(idx) || waitpid(pids.at(idx), &status, WNOHANG) != pids.at(idx)) continue;
+            check(idx, status);
+        }
+        if (!failure.empty()) control->finish();
+    }
+    if (left == 0 && failure.empty() && !control->await_finish(0))
+        failure = "Every prisoner process exited before the challenge was over";
+
+    for (size_t idx = 0; idx < pids.size(); idx++) {
+        if (reaped.at(idx)) continue;
+        int32_t status = 0;
+        while (waitpid(pids.at(idx), &status, 0) < 0 && errno == EINTR) {}
+        check(idx, status);
+    }
+    return failure;
+}
@@ -0,0 +1,177 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for progress.h.                                                   |
+|===========================================================================================================|
+*/
+
+#include <iostream>
+#include <stdexcept>
+#include "parser.h"
+#include "progress.h"
+
+/**
+ * @brief INITIALIZER - Opens the destination for status lines, and starts the sampler thread.
+ *
+ * @details Does nothing unless "--progress" was given. Status lines go to the file given by
+ * "--progress_file", or to stderr, so that they never get mixed into records written to stdout.
+ *
+ * @throws std::runtime_error When the progress file can't be opened.
+ */
+void Progress::start()
+{
+    if (!Parser::progress_is_on()) return;
+
+    std::string path = Parser::get_progress_path();
+    if (!path.empty()) {
+        Progress::file.open(path, std::ios::out | std::ios::trunc);
+        if (!Progress::file.is_open()) throw std::runtime_error("Could not open progress file " + path);
+    }
+    Progress::stopping = false;
+    Progress::sampler = std::thread(Progress::sample, Parser::get_progress_interval());
+}
+
+/**
+ * @brief SETTER - Starts the snapshot over for a new challenge.
+ *
+ * @details Must be called before any prisoner of the new challenge can enter the room, from the thread
+ * that will start them.
+ *
+ * @param number_of_prisoners Number of prisoners who could visit.
+ * @param target Number of times the resetter means to turn the switch off.
+ */
+void Progress::begin(uint32_t number_of_prisoners, uint64_t target)
+{
+    Progress::write_begin();
+    Progress::challenge.fetch_add(1, std::memory_order_relaxed);
+    Progress::entries.store(0, std::memory_order_relaxed);
+    Progress::flips.store(0, std::memory_order_relaxed);
+    Progress::resets.store(0, std::memory_order_relaxed);
+    Progress::reset_target.store(target, std::memory_order_relaxed);
+    Progress::visitors.store(0, std::memory_order_relaxed);
+    Progress::population.store(number_of_prisoners, std::memory_order_relaxed);
+    Progress::write_end();
+}
+
+/**
+ * @brief SETTER - Copies the room's counters into the snapshot.
+ *
+ * @details Must only be called by the prisoner holding the room, so that there is never more than one
+ * writer. Costs a handful of plain stores; nothing here waits on the sampler.
+ *
+ * @param entered Room entries so far.
+ * @param flipped Switch flips so far.
+ * @param distinct Prisoners who have been in at least once.
+ * @param occupant Prisoner about to leave the room; their flips are the resets if they are the resetter.
+ */
+void Progress::publish(uint64_t entered, uint32_t flipped, uint32_t distinct, const Prisoner* occupant)
+{
+    Progress::write_begin();
+    Progress::entries.store(entered, std::memory_order_relaxed);
+    Progress::flips.store(flipped, std::memory_order_relaxed);
+    Progress::visitors.store(distinct, std::memory_order_relaxed);
+    if (occupant->is_resetter())
+        Progress::resets.store(occupant->get_flip_count(), std::memory_order_relaxed);
+    Progress::write_end();
+}
+
+/**
+ * @brief DELETER - Stops the sampler thread, after it writes one last status line, and closes the file.
+ */
+void Progress::stop()
+{
+    if (!Progress::sampler.joinable()) return;
+    {
+        std::lock_guard<std::mutex> guard(Progress::m);
+        Progress::stopping = true;
+    }
+    Progress::wake.notify_all();
+    Progress::sampler.join();
+    if (Progress::file.is_open()) Progress::file.close();
+}
+
+/**
+ * @brief HELPER - Marks the snapshot as being written, by making the sequence number odd.
+ */
+void Progress::write_begin()
+{
+    uint64_t seq = Progress::sequence.load(std::memory_order_relaxed);
+    Progress::sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief HELPER - Marks the snapshot as consistent again, by making the sequence number even.
+ */
+void Progress::write_end()
+{
+    uint64_t seq = Progress::sequence.load(std::memory_order_relaxed);
+    Progress::sequence.store(seq + 1, std::memory_order_release);
+}
+
+/**
+ * @brief HELPER - Reads a consistent copy of the snapshot, retrying if it changed while being read.
+ *
+ * @return Returns the copy.
+ */
+Progress::Snapshot Progress::read()
+{
+    Snapshot copy{};
+    while (true) {
+        uint64_t before = Progress::sequence.load(std::memory_order_acquire);
+        if (before % 2 == 0) {
+            copy.challenge = Progress::challenge.load(std::memory_order_relaxed);
+            copy.entries = Progress::entries.load(std::memory_order_relaxed);
+            copy.flips = Progress::flips.load(std::memory_order_relaxed);
+            copy.resets = Progress::resets.load(std::memory_order_relaxed);
+            copy.reset_target = Progress::reset_target.load(std::memory_order_relaxed);
+            copy.visitors = Progress::visitors.load(std::memory_order_relaxed);
+            copy.population = Progress::population.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Progress::sequence.load(std::memory_order_relaxed) == before) return copy;
+        }
+        std::this_thread::yield();  // the writer only needs a few stores to finish
+    }
+}
+
+/**
+ * @brief SUB METHOD - The sampler thread is started on this method.
+ *
+ * @details Wakes up once per interval until stopped, and writes a line saying how far along the current
+ * challenge is. The rate is the entries since the last line over the time since the last line, so it shows
+ * how fast the run is going now rather than on average.
+ *
+ * @param interval_ms Milliseconds between lines.
+ */
+void Progress::sample(uint32_t interval_ms)
+{
+    std::ostream& out = Progress::file.is_open() ? static_cast<std::ostream&>(Progress::file) : std::cerr;
+    auto interval = std::chrono::milliseconds(interval_ms);
+    auto started = std::chrono::steady_clock::now();
+    auto last_time = started;
+    Snapshot last{};
+    bool done = false;
+
+    while (!done) {
+        {
+            std::unique_lock<std::mutex> lock(Progress::m);
+            done = Progress::wake.wait_for(lock, interval, [] { return Progress::stopping; });
+        }
+        Snapshot now = Progress::read();
+        auto now_time = std::chrono::steady_clock::now();
+        if (now.challenge == 0) continue;   // nothing to report yet
+
+        std::chrono::duration<double> elapsed = now_time - started;
+        std::chrono::duration<double> since = now_time - last_time;
+        uint64_t previous = now.challenge == last.challenge ? last.entries : 0;
+        double rate = since.count() > 0.0 ?
+            static_cast<double>(now.entries - previous) / since.count() : 0.0;
+        out << "[progress " << elapsed.count() << " s] challenge " << now.challenge << ": " << now.entries <<
+            " entries (" << rate << " per second), " << now.flips << " flips, " << now.resets << " of " <<
+            now.reset_target << " resets, " << now.visitors << " of " << now.population << " prisoners in" <<
+            std::endl;
+        last = now;
+        last_time = now_time;
+    }
+}
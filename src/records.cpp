@@ -0,0 +1,134 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for records.h.                                                    |
+|===========================================================================================================|
+*/
+
+#include <cinttypes>
+#include <iostream>
+#include <stdexcept>
+#include "records.h"
+
+/**
+ * @brief INITIALIZER - Opens the destination for records, and writes the CSV header if needed.
+ *
+ * @details Does nothing when the format is text. Records go to the file given by "--output", or to stdout.
+ *
+ * @throws std::runtime_error When the output file can't be opened.
+ */
+void Records::open()
+{
+    out_format f = Parser::get_format();
+    if (f == out_format::f_text) return;
+
+    std::lock_guard<std::mutex> guard(Records::m);
+    std::string path = Parser::get_output_path();
+    if (path.empty()) {
+        std::cout.flush();
+        Records::file = stdout;
+    } else {
+        Records::file = std::fopen(path.c_str(), "w");
+        if (Records::file == nullptr) throw std::runtime_error("Could not open output file " + path);
+    }
+    Records::buffer.reserve(Records::BUFFER_SIZE + 1024);
+    if (f == out_format::f_csv)
+        Records::buffer += "trial,worker,seed,prisoners,rooms,warden,strategy,initial_switch,entries,flips,"
+            "coverage,seconds,cpu_seconds,success,weight\n";
+}
+
+/**
+ * @brief SETTER - Adds one challenge's record, handing the buffer to the OS once it is full.
+ *
+ * @param result What the challenge came to.
+ * @param trial Number of the challenge, counting from 0.
+ * @param worker Number of the worker that ran it, 0 unless trials run in parallel.
+ */
+void Records::write(const ChallengeResult& result, uint64_t trial, uint32_t worker)
+{
+    out_format f = Parser::get_format();
+    if (f == out_format::f_text || Records::file == nullptr) return;
+
+    char line[512];
+    int32_t len = 0;
+    const char* w = Records::warden_name(Parser::get_warden());
+    const char* strat = Parser::get_strategy() == strategy::proper ? "proper" : "improper";
+    const char* initial = result.started_on ? "on" : "off";
+    if (f == out_format::f_json) len = std::snprintf(line, sizeof(line), "{\"trial\":%" PRIu64 ","
+        "\"worker\":%" PRIu32 ",\"seed\":%" PRIu32 ",\"prisoners\":%" PRIu32 ",\"rooms\":%" PRIu32 ","
+        "\"warden\":\"%s\",\"strategy\":\"%s\",\"initial_switch\":\"%s\",\"entries\":%" PRIu64 ","
+        "\"flips\":%" PRIu32 ",\"coverage\":%" PRIu64 ",\"seconds\":%.9g,\"cpu_seconds\":%.9g,\"success\":%s,"
+        "\"weight\":%.17g}\n", trial, worker, Parser::get_seed(), Parser::get_number_of_prisoners(),
+        Parser::get_rooms(), w, strat, initial, result.entries, result.flips, result.coverage, result.seconds,
+        result.cpu_seconds, result.success ? "true" : "false", result.weight);
+    else len = std::snprintf(line, sizeof(line), "%" PRIu64 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32
+        ",%s,%s,%s,%" PRIu64 ",%" PRIu32 ",%" PRIu64 ",%.9g,%.9g,%d,%.17g\n", trial, worker,
+        Parser::get_seed(), Parser::get_number_of_prisoners(), Parser::get_rooms(), w, strat, initial,
+        result.entries, result.flips, result.coverage, result.seconds, result.cpu_seconds,
+        result.success ? 1 : 0, result.weight);
+    if (len <= 0) return;
+
+    std::lock_guard<std::mutex> guard(Records::m);
+    Records::buffer.append(line, static_cast<size_t>(len));
+    if (Records::buffer.size() >= Records::BUFFER_SIZE) Records::flush();
+}
+
+/**
+ * @brief DELETER - Hands whatever is left in the buffer to the OS, and closes the output file if any.
+ */
+void Records::close()
+{
+    std::lock_guard<std::mutex> guard(Records::m);
+    if (Records::file == nullptr) return;
+    Records::flush();
+    if (Records::file == stdout) std::fflush(stdout);
+    else std::fclose(Records::file);
+    Records::file = nullptr;
+}
+
+/**
+ * @brief HELPER - Writes the buffer out in one go and empties it. The mutex must already be held.
+ */
+void Records::flush()
+{
+    if (!Records::buffer.empty())
+        std::fwrite(Records::buffer.data(), 1, Records::buffer.size(), Records::file);
+    Records::buffer.clear();
+}
+
+/**
+ * @brief HELPER - Translates a warden into the name used for it on the command line.
+ *
+ * @param w Warden to name.
+ * @return Returns the name.
+ */
+const char* Records::warden_name(warden w)
+{
+    switch (w) {
+        case warden::os:
+            return "os";
+        case warden::pseudo:
+            return "pseudo";
+        case warden::fixed:
+            return "fixed";
+        case warden::seq:
+            return "seq";
+        case warden::fast:
+            return "fast";
+        case warden::handoff:
+            return "handoff";
+        case warden::weighted:
+            return "weighted";
+        case warden::event:
+            return "event";
+        case warden::cfs:
+            return "cfs";
+        case warden::process:
+            return "process";
+        case warden::coro:
+            return "coro";
+        default:
+            return "unknown";
+    }
+}
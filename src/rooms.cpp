@@ -0,0 +1,215 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for rooms.h.                                                      |
+|===========================================================================================================|
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+#include "global.h"
+#include "parser.h"
+#include "prison.h"
+#include "rooms.h"
+#include "threading.h"
+#include "trace.h"
+
+
+/*=============================================== Rooms ===================================================*/
+
+/**
+ * @brief GETTER - Works out which room a prisoner belongs to.
+ *
+ * @details Prisoners are dealt out to the rooms counting down from the last index, so that the resetter (the
+ * last prisoner) lands in room 0, the prisoner before them in room 1, and so on, and the rooms' sizes never
+ * differ by more than one.
+ *
+ * @param index Unique index of the prisoner, from 1 to the number of prisoners.
+ * @param number_of_prisoners Number of prisoners in the prison.
+ * @param number_of_rooms Number of switch rooms, from 1 to the number of prisoners.
+ * @return Returns the room's number, from 0 to the number of rooms - 1.
+ */
+uint32_t Rooms::room_of(uint32_t index, uint32_t number_of_prisoners, uint32_t number_of_rooms)
+{
+    return (number_of_prisoners - index) % number_of_rooms;
+}
+
+/**
+ * @brief GETTER - Works out how many prisoners belong to a room, counting whoever counts there.
+ *
+ * @param room Number of the room, from 0 to the number of rooms - 1.
+ * @param number_of_prisoners Number of prisoners in the prison.
+ * @param number_of_rooms Number of switch rooms, from 1 to the number of prisoners.
+ * @return Returns an integer greater than or equal to 1.
+ */
+uint32_t Rooms::size_of(uint32_t room, uint32_t number_of_prisoners, uint32_t number_of_rooms)
+{
+    return (number_of_prisoners - 1 - room) / number_of_rooms + 1;
+}
+
+/**
+ * @brief GETTER - Works out whether a prisoner is the relay of their room.
+ *
+ * @details The relay of a room other than room 0 is the first prisoner dealt to it, which is the one with
+ * the highest index in it.
+ *
+ * @param index Unique index of the prisoner, from 1 to the number of prisoners.
+ * @param number_of_prisoners Number of prisoners in the prison.
+ * @param number_of_rooms Number of switch rooms, from 1 to the number of prisoners.
+ * @return Returns true for the relays, false for the setters and the resetter.
+ */
+bool Rooms::is_relay(uint32_t index, uint32_t number_of_prisoners, uint32_t number_of_rooms)
+{
+    return index < number_of_prisoners && number_of_prisoners - index < number_of_rooms;
+}
+
+
+/*=============================================== Relay ===================================================*/
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object.
+ *
+ * @param index unique number assigned to the prisoner for easier identification purposes.
+ * @param room_number Switch room the relay counts in, from 1 to the number of rooms - 1.
+ * @param counted Number of setters in that room.
+ */
+Relay::Relay(uint32_t index, uint32_t room_number, uint32_t counted) : Resetter(index, room_number, counted)
+{
+    this->to_string_internal(index, " (Relay)");
+    if (Parser::debug_is_on()) std::cout << "==" << Global::PID << "== Calculated Relay target count for " <<
+        "room " << room_number << " as: " << this->get_target_count() << std::endl;
+}
+
+/**
+ * @brief DECONSTRUCTOR - Frees memory.
+ */
+Relay::~Relay() {}
+
+/**
+ * @brief SETTER - Tells the relay which room to carry the count to.
+ *
+ * @details Must be called before the relay's first visit. The relay does not take ownership.
+ *
+ * @param chief The chief's room, room 0.
+ */
+void Relay::set_chief_room(SwitchRoom* chief)
+{
+    this->chief_room = chief;
+}
+
+/**
+ * @brief HELPER - Called once the relay's own room is counted; instead of declaring completion, they start
+ * carrying the count to the chief's room.
+ *
+ * @param challenge_finished Left as it is, since a relay never ends the challenge.
+ */
+void Relay::finish_counting(bool* challenge_finished)
+{
+    this->done_counting = true;
+    if (Parser::verbose_is_on()) {
+        Global::output_mutex.lock();
+        std::cout << "  --> They have counted their room, so they start carrying the count to room 0." <<
+            std::endl;
+        Global::output_mutex.unlock();
+    }
+}
+
+/**
+ * @brief SUB METHOD - A thread should be started on this method.
+ *
+ * The prison will have every prisoner attempt to carry out their tasks concurrently.
+ * Relays first count their own room exactly like the resetter, and then visit the chief's room instead,
+ * where they want to turn the switch up exactly as many steps as a setter does.
+ *
+ * @param challenge_finished Starts false, and gets set to true when a prisoner thinks they have won.
+ *  True breaks the loop, which would otherwise be infinite.
+ * @param switch_room The relay's own room.
+ */
+void Relay::perform_task(bool* challenge_finished, SwitchRoom* switch_room)
+{
+    if (!this->done_counting) {
+        Resetter::perform_task(challenge_finished, switch_room);
+        if (!Prison::is_threaded()) return;     // that was this call's one visit
+    }
+    this->carry(challenge_finished);
+}
+
+/**
+ * @brief HELPER - The loop a relay follows once their own room is counted, visiting the chief's room.
+ *
+ * @param challenge_finished Starts false, and gets set to true when a prisoner thinks they have won.
+ *  True breaks the loop, which would otherwise be infinite.
+ */
+void Relay::carry(bool* challenge_finished)
+{
+    SwitchRoom* switch_room = this->chief_room;
+    std::thread::id tid = std::this_thread::get_id();
+    while (!*challenge_finished) {
+        // try to unlock the chief's room
+        switch_room->unlock(this);
+        if (*challenge_finished) {  // it's possible this changed while this prisoner was waiting to enter
+            if (Parser::verbose_is_on()) {
+                Global::output_mutex.lock();
+                std::cout << std::endl << "  --> They stop because the challenge is over." << std::endl;
+                Global::output_mutex.unlock();
+            }
+            switch_room->lock(this);
+            continue;
+        }
+        this->entered_count++;
+        switch_room->enter(this);
+
+        // if this relay has already carried the count, they should just leave immediately
+        if (this->carried >= Relay::carry_target)
+            switch_room->exit(this, "leave without doing anything (because they are done)");
+
+        // check the position of the switch; if it can't be turned up any further, leave immediately
+        uint8_t position = 0;
+        bool inside = switch_room->check_switch(this, &position);  // false if they have already left
+        if (inside && position == RoomSwitch::TOP)
+            switch_room->exit(this, Global::POSITIONS == 2 ? "leave without doing anything (because the "
+                "switch is on)" : "leave without doing anything (because the switch is all the way up)");
+
+        // otherwise, turn it up as far as it goes, or as far as they still want to
+        else if (inside) {
+            uint8_t to = static_cast<uint8_t>(std::min<uint32_t>(RoomSwitch::TOP,
+                static_cast<uint32_t>(position) + Relay::carry_target - this->carried));
+            switch_room->turn_switch(this, to);
+            this->carried = static_cast<uint8_t>(this->carried + to - position);
+            if (Parser::verbose_is_on()) {
+                Global::output_mutex.lock();
+                std::cout << "  --> They have now " << (Global::POSITIONS == 2 ?
+                    "flipped the chief's switch " : "turned the chief's switch up ") << +this->carried <<
+                    (Global::POSITIONS == 2 ? " time(s)." : " step(s).") << std::endl;
+                Global::output_mutex.unlock();
+            }
+            switch_room->exit(this);
+        }
+
+        // once done, a relay can never matter again, so they may park instead
+        bool parking = Prison::is_threaded() && Parser::park_is_on() && this->carried >= Relay::carry_target;
+        if (parking) switch_room->park(this);
+
+        // lock the chief's room so that the next prisoner may unlock it
+        switch_room->lock(this);
+        if (!Prison::is_threaded()) break;
+        if (parking && Parser::get_warden() == warden::process) break;    // a process just ends instead
+        if (parking) {
+            TRACE_BEGIN("parked");
+            Threading::park_wait();
+            TRACE_END("parked");
+            continue;
+        }
+        if (Parser::debug_is_on()) {
+            Global::output_mutex.lock();
+            std::cout << "==" << tid << "== Sleeping for " << Global::WAIT_TIME << " seconds." << std::endl;
+            Global::output_mutex.unlock();
+        }
+        TRACE_BEGIN("backing off");
+        sleep(Global::WAIT_TIME);
+        TRACE_END("backing off");
+    }
+}
@@ -21,41 +21,130 @@ Isaac Jung
 |===========================================================================================================|
 */
 
+#include <cmath>
 #include <cstring>
 #include <iostream>
 #include <sched.h>
+#include "adaptive.h"
+#include "ensemble.h"
 #include "global.h"
+#include "jobs.h"
 #include "parser.h"
 #include "prison.h"
+#include "simulator.h"
+#include "stats.h"
+#include "threading.h"
+#include "timing.h"
 
+static int32_t run(int32_t argc, char *argv[]);
 static int32_t print_usage();
 static void debug_print();
+static void print_intervals(const TrialStats& stats);
+static void print_failure_estimate(const TrialStats& stats);
 
 /**
  * @brief MAIN METHOD - Called when program is executed.
  * 
  * @param argc Number of arguments given by caller (including the token used to call).
  * @param argv Vector containing the arguments given by the caller.
- * @return Exit code representing the state of the program (0 means the program finished successfully).
+ * @return Exit code representing the outcome (0 means the prisoners went free in every trial, of every job
+ * if there is a jobs file, 1 means they didn't, 2 means the simulation could not be run, such as when the OS
+ * won't allow enough threads).
  */
 int32_t main(int32_t argc, char *argv[])
 {
     if (argc > 1 && std::strcmp(argv[1], "--help") == 0) return print_usage();
+    try {
+        return run(argc, argv);
+    } catch (const std::runtime_error& e) {
+        std::cout.flush();
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 2;
+    }
+}
+
+/**
+ * @brief SUB METHOD - Parses the command line, runs every trial, or every job, and reports on them.
+ *
+ * @param argc Number of arguments given by caller (including the token used to call).
+ * @param argv Vector containing the arguments given by the caller.
+ * @return Exit code representing the outcome, as described for main().
+ * @throws std::runtime_error When the simulation can't be run as asked.
+ */
+static int32_t run(int32_t argc, char *argv[])
+{
+    Timing::begin(phase::ph_parse);
     Parser::parse(argc, argv);
+    Timing::end(phase::ph_parse);
     int32_t pid = Global::PID;
     bool debug_enabled = Parser::debug_is_on();
     if (debug_enabled) debug_print();
-    
-    Prison::init();
-    bool success = Prison::challenge();
-    Prison::free_memory();
 
-    if (success) std::cout << std::endl << "The prisoners all go free!" << std::endl;
+    if (!Parser::get_jobs_path().empty()) {
+        bool success = Jobs::run(Parser::get_given_config());
+        if (Parser::timing_is_on() && !Parser::records_own_stdout()) Timing::print();
+        return success ? 0 : 1;
+    }
+
+    Results results = Simulator::run(Parser::get_config());
+    if (Parser::records_own_stdout()) return results.success ? 0 : 1;
+    if (Parser::timing_is_on()) Timing::print();
+
+    const TrialStats& stats = results.stats;
+    uint64_t trials = results.trials;
+    if (trials > 1) stats.print();
+    if (Parser::importance_is_on()) print_failure_estimate(stats);
+    if (Parser::adaptive_is_on()) print_intervals(stats);
+    if (trials > 1) std::cout << std::endl << "The prisoners went free in " << results.successes << " of " <<
+        trials << " trials." << std::endl;
+    else if (results.success) std::cout << std::endl << "The prisoners all go free!" << std::endl;
     else std::cout << std::endl << "The prisoners are doomed!" << std::endl;
 
     if (debug_enabled && !Parser::seed_is_from_user())
-        std::cout << std::endl << "==" << pid << "== The seed was: " << Parser::get_seed() << std::endl;
-    return 0;
+        std::cout << std::endl << "==" << pid << "== The seed was: " << results.seed << std::endl;
+    return results.success ? 0 : 1;
+}
+
+/**
+ * @brief HELPER - Prints the importance sampling estimate of the failure probability, with its error.
+ *
+ * @details The count of failures printed elsewhere is what happened under the biased warden, which is
+ * deliberately far more than would happen under the real one; this is the reweighed, unbiased estimate.
+ *
+ * @param stats Summary of every trial that was run.
+ */
+static void print_failure_estimate(const TrialStats& stats)
+{
+    const Welford& failures = stats.get_weighted_failures();
+    double n = static_cast<double>(failures.get_count());
+    double p = failures.get_mean();
+    double error = std::sqrt(failures.get_variance() / n);
+    std::cout << std::endl << "Estimated failure probability (importance sampling, bias " <<
+        Parser::get_bias() << "): " << p << std::endl;
+    std::cout << "  standard error " << error << ", variance of the estimator " << error * error;
+    if (p > 0.0) std::cout << ", relative error " << error / p;
+    std::cout << std::endl << "  " << stats.get_trials() - stats.get_successes() << " of " <<
+        stats.get_trials() << " biased trials failed" << std::endl;
+}
+
+/**
+ * @brief HELPER - Prints how precisely an adaptive run pinned down the success rate and the mean entries.
+ *
+ * @param stats Summary of every trial that was run.
+ */
+static void print_intervals(const TrialStats& stats)
+{
+    uint64_t n = stats.get_trials();
+    double rate = static_cast<double>(stats.get_successes()) / static_cast<double>(n);
+    const Welford& entries = stats.get_entries().get_moments();
+    if (Parser::importance_is_on()) rate = 1.0 - stats.get_weighted_failures().get_mean();
+    std::cout << std::endl << "Success rate: " << rate << " +/- " << Adaptive::success_half_width(stats) <<
+        (Parser::importance_is_on() ? " (95% interval)" : " (95% Wilson interval)") << std::endl;
+    std::cout << "Mean entries: " << entries.get_mean() << " +/- " << Adaptive::t_half_width(entries) <<
+        " (95% t-interval)" << std::endl;
+    std::cout << (n >= Parser::get_budget() ? "The budget of " + std::to_string(Parser::get_budget()) +
+        " trials ran out before the target was met" : "The target was met after " + std::to_string(n) +
+        " trials") << ", using " << Parser::get_workers() << " worker(s)." << std::endl;
 }
 
 /**
@@ -71,6 +160,11 @@ static int32_t print_usage()
     std::cout << "\t\t--> for example, enable this to see what seed the program is using" << std::endl;
     std::cout << "\t-h : halfway mode (prints less output than normal)" << std::endl;
     std::cout << "\t\t--> output will state who enters, but not what decisions they make" << std::endl;
+    std::cout << "\t-p : performance counter mode (prints hardware and OS counters for the challenge)" <<
+        std::endl;
+    std::cout << "\t\t--> counts are also shown per room entry; perf events may need privileges" << std::endl;
+    std::cout << "\t-t : timing mode (prints how long each phase of the program took)" << std::endl;
+    std::cout << "\t\t--> phases are parse, init, spawn, contest, verify, and teardown" << std::endl;
     std::cout << "\t-s : silent mode (prints minimal or no output, overrides -h and -v)" << std::endl;
     std::cout << "\t\t--> output will include only final result of challenge" << std::endl;
     std::cout << "\t-v : verbose mode (prints more output than normal)" << std::endl;
@@ -90,6 +184,15 @@ static int32_t print_usage()
     std::cout << "\t\t\t3. fixed : random permutation repeated until challenge ends" << std::endl;
     std::cout << "\t\t\t4. seq/sequential : like fixed but not a permutation; in order" << std::endl;
     std::cout << "\t\t\t5. fast : like seq but resetter goes in every other time" << std::endl;
+    std::cout << "\t\t\t6. handoff/directed : threads, but the one leaving picks who goes next" << std::endl;
+    std::cout << "\t\t\t7. weighted/skewed : like pseudo, but some prisoners are favored" << std::endl;
+    std::cout << "\t\t\t8. event/des/discrete : each prisoner visits on their own clock, in virtual days" <<
+        std::endl;
+    std::cout << "\t\t\t9. cfs/fair : single threaded emulation of a fair scheduler" << std::endl;
+    std::cout << "\t\t\t10. process/proc/fork : like os, but prisoners are processes sharing memory" <<
+        std::endl;
+    std::cout << "\t\t\t11. coro/coroutine/green : prisoners are coroutines run by a pool of threads" <<
+        std::endl;
     std::cout << "\t--strategy=<mode> : prisoner strategy, guaranteed success by default" << std::endl;
     std::cout << "\t\t--> equivalent options are --strat and --st" << std::endl;
     std::cout << "\t\t--> valid values of <mode> are:" << std::endl;
@@ -99,10 +202,144 @@ static int32_t print_usage()
     std::cout << "\t\t--> equivalent option is --se" << std::endl;
     std::cout << "\t\t--> <value> must be parsable as an unsigned 32-bit integer" << std::endl;
     std::cout << "\t\t\t-- if not provided, seed will be randomly generated at runtime" << std::endl;
+    std::cout << "\t--trials=<value> : number of challenges to run one after another, 1 by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --tr" << std::endl;
+    std::cout << "\t\t--> with more than 1, percentiles and a histogram over all trials are printed" <<
+        std::endl;
+    std::cout << "\t--ci=<half-width> : run trials until the success rate is known to +/- this (95%)" <<
+        std::endl;
+    std::cout << "\t--entries_ci=<fraction> : run trials until mean entries are known to +/- this fraction" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --eci" << std::endl;
+    std::cout << "\t\t--> either one turns on adaptive mode, which ignores --trials" << std::endl;
+    std::cout << "\t--budget=<value> : most trials adaptive mode may run, 1000000 by default" << std::endl;
+    std::cout << "\t--workers=<value> : threads running trials in adaptive mode, or jobs, one per CPU by " <<
+        "default" << std::endl;
+    std::cout << "\t\t--> equivalent option is --wk" << std::endl;
+    std::cout << "\t\t--> more than 1 forces -s, and needs a single threaded warden" << std::endl;
+    std::cout << "\t--bias=<b> : estimate the failure rate by importance sampling (pseudo, improper only)" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --is" << std::endl;
+    std::cout << "\t\t--> prisoners who have been in are picked b times as often, b >= 1; off by default" <<
+        std::endl;
+    std::cout << "\t--ensemble=<engine> : run pseudo warden challenges side by side in vector lanes" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --ens" << std::endl;
+    std::cout << "\t\t--> valid values of <engine> are:" << std::endl;
+    std::cout << "\t\t\t1. off/0/no : run every challenge in the prison (default)" << std::endl;
+    std::cout << "\t\t\t2. on/auto/1/yes : the widest engine the CPU supports" << std::endl;
+    std::cout << "\t\t\t3. avx512 : 16 challenges at a time" << std::endl;
+    std::cout << "\t\t\t4. avx2 : 8 challenges at a time" << std::endl;
+    std::cout << "\t\t\t5. scalar : 1 challenge at a time, with the same random numbers" << std::endl;
+    std::cout << "\t\t--> needs 1 switch room and no --bias; forces -s; its seeds give other challenges" <<
+        std::endl;
+    std::cout << "\t--policy=<policy> : scheduling policy of prisoner threads (os warden only)" << std::endl;
+    std::cout << "\t\t--> equivalent options are --sched and --pol" << std::endl;
+    std::cout << "\t\t--> valid values of <policy> are:" << std::endl;
+    std::cout << "\t\t\t1. inherit/default : keep the policy of the main thread (default)" << std::endl;
+    std::cout << "\t\t\t2. other/normal/cfs : SCHED_OTHER, combine with --nice" << std::endl;
+    std::cout << "\t\t\t3. batch : SCHED_BATCH" << std::endl;
+    std::cout << "\t\t\t4. idle : SCHED_IDLE" << std::endl;
+    std::cout << "\t\t\t5. fifo : SCHED_FIFO, combine with --priority (needs privileges)" << std::endl;
+    std::cout << "\t\t\t6. rr/roundrobin : SCHED_RR, combine with --priority (needs privileges)" << std::endl;
+    std::cout << "\t--nice=<value> : nice value of prisoner threads, -20 to 19, unchanged by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --n" << std::endl;
+    std::cout << "\t--priority=<value> : real-time priority for fifo/rr, 1 to 99, 1 by default" << std::endl;
+    std::cout << "\t\t--> equivalent option is --prio" << std::endl;
+    std::cout << "\t--resetter_policy=<policy>, --resetter_nice=<value>, --resetter_priority=<value> :" <<
+        std::endl;
+    std::cout << "\t\t--> same as above, but only for the resetter's thread; setters' otherwise" << std::endl;
+    std::cout << "\t\t--> equivalent options are --resetter_sched/--rpol, --rn, and --rprio" << std::endl;
+    std::cout << "\t--handoff=<policy> : who goes next under the handoff or coro warden, random by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --ho" << std::endl;
+    std::cout << "\t\t--> valid values of <policy> are:" << std::endl;
+    std::cout << "\t\t\t1. random/rand : any waiting prisoner, chosen with the seed (default)" << std::endl;
+    std::cout << "\t\t\t2. rr/roundrobin : next waiting prisoner by number after the last one" << std::endl;
+    std::cout << "\t\t\t3. lrv/least_recent : waiting prisoner who left the room longest ago" << std::endl;
+    std::cout << "\t--pool=<threads> : threads running the prisoners under the coro warden, 1 per CPU by " <<
+        "default" << std::endl;
+    std::cout << "\t\t--> valid values of <threads> are 1 to 1024" << std::endl;
+    std::cout << "\t--weights=<source> : per-prisoner weights for the weighted warden, zipf by default" <<
+        std::endl;
+    std::cout << "\t\t--> valid values of <source> are:" << std::endl;
+    std::cout << "\t\t\t1. zipf : the k-th most frequent prisoner has weight 1/k (default)" << std::endl;
+    std::cout << "\t\t\t2. zipf:<s> : the k-th most frequent prisoner has weight 1/k^s, 0 <= s <= 100" <<
+        std::endl;
+    std::cout << "\t\t\t3. file:<path> : one weight per prisoner, in order, read from <path>" << std::endl;
+    std::cout << "\t--arrivals=<dist> : time between one prisoner's visits (event warden), exp by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --arr" << std::endl;
+    std::cout << "\t\t--> valid values of <dist> are:" << std::endl;
+    std::cout << "\t\t\t1. exp/exponential/poisson : visits form a Poisson process (default)" << std::endl;
+    std::cout << "\t\t\t2. uniform/uni : uniform between 0 and twice the period" << std::endl;
+    std::cout << "\t\t\t3. fixed/periodic : exactly one period, starting at a random phase" << std::endl;
+    std::cout << "\t--period=<days> : mean days between one prisoner's visits, prisoner count by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --per" << std::endl;
+    std::cout << "\t--granularity=<ns> : minimum time slice under the cfs warden, 750000 by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --gran" << std::endl;
+    std::cout << "\t--visit_cost=<ns> : time one visit takes under the cfs warden, 1000 by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --cost" << std::endl;
+    std::cout << "\t--start=<mode> : how prisoner threads are released (os warden only)" << std::endl;
+    std::cout << "\t\t--> valid values of <mode> are:" << std::endl;
+    std::cout << "\t\t\t1. gate/barrier : all threads are created and parked, then released (default)" <<
+        std::endl;
+    std::cout << "\t\t\t2. stagger/staggered : like gate, but threads are released one by one" << std::endl;
+    std::cout << "\t\t\t3. free/none : each thread starts as soon as it is created" << std::endl;
+    std::cout << "\t--stagger=<value> : microseconds between releases in stagger mode, 100 by default" <<
+        std::endl;
+    std::cout << "\t--park=<on/off> : finished setters sleep instead of revisiting (threaded wardens)" <<
+        std::endl;
+    std::cout << "\t\t--> only applies to the proper strategy; off by default" << std::endl;
+    std::cout << "\t--pin=<on/off> : pin prisoner threads to CPUs round robin, off by default" << std::endl;
+    std::cout << "\t--stack=<KiB> : stack size of each prisoner thread, 128 by default" << std::endl;
+    std::cout << "\t\t--> equivalent option is --stk" << std::endl;
+    std::cout << "\t\t--> the OS's thread and memory limits are checked before any thread is created" <<
+        std::endl;
+    std::cout << "\t--rooms=<value> : number of switch rooms, each with its own lock and switch, " <<
+        "1 by default" << std::endl;
+    std::cout << "\t\t--> equivalent option is --rm" << std::endl;
+    std::cout << "\t\t--> prisoners are dealt out to the rooms; a relay counts each room after the " <<
+        "first, and" << std::endl;
+    std::cout << "\t\t    then carries the count to the resetter in room 0" << std::endl;
+    std::cout << "\t--format=<format> : how results are written, text by default" << std::endl;
+    std::cout << "\t\t--> equivalent option is --fmt" << std::endl;
+    std::cout << "\t\t--> valid values of <format> are:" << std::endl;
+    std::cout << "\t\t\t1. text/txt : the usual human readable output (default)" << std::endl;
+    std::cout << "\t\t\t2. json/jsonl : one JSON object per challenge, one per line" << std::endl;
+    std::cout << "\t\t\t3. csv : a header, then one row per challenge" << std::endl;
+    std::cout << "\t--output=<path> : file json/csv records are written to, stdout by default" << std::endl;
+    std::cout << "\t\t--> equivalent option is --out" << std::endl;
+    std::cout << "\t\t--> records on stdout force -s and replace the usual summary" << std::endl;
+    std::cout << "\t--progress=<ms> : print a status line this often while challenges run, off by default" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --prog" << std::endl;
+    std::cout << "\t\t--> lines go to stderr; only 1 adaptive worker can be followed" << std::endl;
+    std::cout << "\t--progress_file=<path> : file progress lines are written to instead of stderr" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --pf" << std::endl;
+    std::cout << "\t--trace=<path> : Chrome trace of every thread's activity to <path>, off by default" <<
+        std::endl;
+    std::cout << "\t\t--> open it in Perfetto or chrome://tracing; compiled out by \"make notrace\"" <<
+        std::endl;
+    std::cout << "\t--jobs=<path> : run every line of <path> as a run of its own, writing a line for each" <<
+        std::endl;
+    std::cout << "\t\t--> equivalent option is --batch" << std::endl;
+    std::cout << "\t\t--> lines hold arguments like the command line's, which fills in what they leave out" <<
+        std::endl;
+    std::cout << "\t\t--> jobs run on --workers threads; lines are written in order, in the --format given" <<
+        std::endl;
     std::cout << "\t--help : print help message (what you are seeing here)" << std::endl;
     std::cout << std::endl << "arguments (no hyphens):" << std::endl;
     std::cout << "\tnumber of prisoners : total prisoners, must be >= 1, defaults to 100" << std::endl;
     std::cout << std::endl << "The order of flags, options, and arguments does not matter." << std::endl;
+    std::cout << "The exit code is 0 if the prisoners went free in every trial, 1 if not, and 2 on errors." <<
+        std::endl;
     std::cout << "For more details, please refer to the README." << std::endl;
     return 0;
 }
@@ -125,41 +362,129 @@ static void debug_print() {
     if (!verbose_enabled) std::cout << "==" << pid << "== Verbose mode: disabled" << std::endl;
     else std::cout << "==" << pid << "== Verbose mode: enabled" << std::endl;
 
+    if (!Parser::counters_are_on())
+        std::cout << "==" << pid << "== Performance counters: disabled" << std::endl;
+    else std::cout << "==" << pid << "== Performance counters: enabled" << std::endl;
+
+    if (!Parser::timing_is_on()) std::cout << "==" << pid << "== Phase timing: disabled" << std::endl;
+    else std::cout << "==" << pid << "== Phase timing: enabled" << std::endl;
+
     if (o == out_mode::normal) std::cout << "==" << pid << "== Output mode: normal" << std::endl;
     else if (o == out_mode::halfway) std::cout << "==" << pid << "== Output mode: halfway" << std::endl;
     else if (o == out_mode::silent) std::cout << "==" << pid << "== Output mode: silent" << std::endl;
     
+    out_format f = Parser::get_format();
+    if (f != out_format::f_text) std::cout << "==" << pid << "== Record format: " <<
+        (f == out_format::f_json ? "json" : "csv") << " to " <<
+        (Parser::get_output_path().empty() ? "stdout" : Parser::get_output_path()) << std::endl;
+
+    if (Parser::progress_is_on()) std::cout << "==" << pid << "== Progress: every " <<
+        Parser::get_progress_interval() << " ms to " <<
+        (Parser::get_progress_path().empty() ? "stderr" : Parser::get_progress_path()) << std::endl;
+
+    if (!Parser::get_trace_path().empty())
+        std::cout << "==" << pid << "== Trace file: " << Parser::get_trace_path() << std::endl;
+
+    if (!Parser::get_jobs_path().empty()) std::cout << "==" << pid << "== Jobs file: " <<
+        Parser::get_jobs_path() << " (at most " << Parser::get_workers() << " worker(s))" << std::endl;
+
+    std::cout << "==" << pid << "== Memory layout: " << (Global::PACKED ? "packed" : "cache-aligned") <<
+        " (" << sizeof(Setter) << " bytes per setter, " << sizeof(SwitchRoom) << " bytes per room)" <<
+        std::endl;
+
     std::cout << "==" << pid << "== Number of prisoners: " << Parser::get_number_of_prisoners() << std::endl;
+    std::cout << "==" << pid << "== Number of switch rooms: " << Parser::get_rooms() << std::endl;
+    if (Parser::adaptive_is_on()) {
+        std::cout << "==" << pid << "== Number of trials: adaptive, at most " << Parser::get_budget() <<
+            " on " << Parser::get_workers() << " worker(s)" << std::endl;
+        if (Parser::get_ci() > 0.0) std::cout << "==" << pid << "==  - Success rate to within +/- " <<
+            Parser::get_ci() << std::endl;
+        if (Parser::get_entries_ci() > 0.0) std::cout << "==" << pid << "==  - Mean entries to within +/- " <<
+            Parser::get_entries_ci() * 100 << "%" << std::endl;
+    } else std::cout << "==" << pid << "== Number of trials: " << Parser::get_trials() << std::endl;
 
+    std::cout << "==" << pid << "== Switch positions: " << +Global::POSITIONS << std::endl;
     if (i_s == switch_state::unknown) std::cout << "==" << pid << "== Switch state: unknown" << std::endl;
     else if (i_s == switch_state::on) std::cout << "==" << pid << "== Switch state: on" << std::endl;
     else if (i_s == switch_state::off) std::cout << "==" << pid << "== Switch state: off" << std::endl;
     else std::cout << "==" << pid << "== WARNING: SWITCH STATE APPEARS INVALID." << std::endl;
 
     if (w == warden::os) std::cout << "==" << pid << "== Warden: os" << std::endl;
+    else if (w == warden::pseudo && Parser::importance_is_on()) std::cout << "==" << pid <<
+        "== Warden: pseudorandom (importance sampled, bias " << Parser::get_bias() << ")" << std::endl;
     else if (w == warden::pseudo) std::cout << "==" << pid << "== Warden: pseudorandom" << std::endl;
     else if (w == warden::fixed) std::cout << "==" << pid << "== Warden: fixed" << std::endl;
     else if (w == warden::seq) std::cout << "==" << pid << "== Warden: sequential" << std::endl;
     else if (w == warden::fast) std::cout << "==" << pid << "== Warden: fast" << std::endl;
+    else if (w == warden::handoff) {
+        handoff_policy h_p = Parser::get_handoff_policy();
+        std::cout << "==" << pid << "== Warden: handoff (" << (h_p == handoff_policy::h_rr ? "rr" :
+            (h_p == handoff_policy::h_lrv ? "lrv" : "random")) << ")" << std::endl;
+    }
+    else if (w == warden::weighted) {
+        std::cout << "==" << pid << "== Warden: weighted (";
+        if (Parser::get_weight_source() == weight_source::w_zipf)
+            std::cout << "zipf, s = " << Parser::get_zipf_exponent() << ")" << std::endl;
+        else std::cout << "file " << Parser::get_weights_path() << ")" << std::endl;
+    }
+    else if (w == warden::event) {
+        arrival_mode a_m = Parser::get_arrival_mode();
+        std::cout << "==" << pid << "== Warden: event (" << (a_m == arrival_mode::a_exp ? "exp" :
+            (a_m == arrival_mode::a_uniform ? "uniform" : "fixed")) << " arrivals, period of " <<
+            Parser::get_period() << " days)" << std::endl;
+    }
+    else if (w == warden::cfs) std::cout << "==" << pid << "== Warden: cfs (granularity of " <<
+        Parser::get_granularity() << " ns, visit cost of " << Parser::get_visit_cost() << " ns)" << std::endl;
+    else if (w == warden::process) std::cout << "==" << pid << "== Warden: process" << std::endl;
+    else if (w == warden::coro) {
+        handoff_policy h_p = Parser::get_handoff_policy();
+        std::cout << "==" << pid << "== Warden: coro (" << Parser::get_pool_size() << " pool thread(s), " <<
+            (h_p == handoff_policy::h_rr ? "rr" : (h_p == handoff_policy::h_lrv ? "lrv" : "random")) <<
+            " handoff)" << std::endl;
+    }
     else std::cout << "==" << pid << "== WARNING: WARDEN APPEARS INVALID." << std::endl;
 
-    if (w == warden::os) {
-        std::cout << "==" << pid << "==  - Scheduling Policy: ";
-        switch (sched_getscheduler(pid)) {
-            case SCHED_FIFO:
-                std::cout << "SCHED_FIFO (First In, First Out)";
-                break;
-            case SCHED_RR:
-                std::cout << "SCHED_RR (Round Robin)";
-                break;
-            case SCHED_OTHER:
-                std::cout << "SCHED_OTHER (Completely Fair Scheduler - CFS)";
-                break;
-            default:
-                std::cout << "Unknown";
-                break;
+    if (Parser::ensemble_is_on()) {
+        Ensemble ensemble(Parser::get_ensemble_mode(), Parser::get_number_of_prisoners());
+        std::cout << "==" << pid << "==  - Ensemble: " << Ensemble::name(ensemble.get_engine()) << " (" <<
+            ensemble.get_lanes() << " challenge(s) at a time)" << std::endl;
+    }
+
+    if (w == warden::os || w == warden::handoff || w == warden::process) {
+        std::cout << "==" << pid << "==  - Scheduling Policy: " <<
+            Threading::policy_name(sched_getscheduler(pid)) << std::endl;
+        start_mode s_m = Parser::get_start_mode();
+        std::cout << "==" << pid << "==  - Start mode: ";
+        if (s_m == start_mode::s_gate) std::cout << "gate" << std::endl;
+        else if (s_m == start_mode::s_stagger)
+            std::cout << "stagger (" << Parser::get_stagger() << " microseconds)" << std::endl;
+        else std::cout << "free" << std::endl;
+        std::cout << "==" << pid << "==  - Parking finished setters: " <<
+            (Parser::park_is_on() ? "on" : "off") << std::endl;
+        std::cout << "==" << pid << "==  - CPU pinning: " << (Parser::pin_is_on() ? "on" : "off") <<
+            std::endl;
+        if (w != warden::process) {
+            std::string limit;
+            uint64_t capacity = Threading::thread_capacity(Parser::get_stack_size(), &limit);
+            std::cout << "==" << pid << "==  - Thread stack: " << Parser::get_stack_size() / 1024 << " KiB (";
+            if (limit.empty()) std::cout << "no thread limits found)" << std::endl;
+            else std::cout << "room for about " << capacity << " threads, set by " << limit << ")" <<
+                std::endl;
+        }
+        for (bool resetter : {false, true}) {
+            sched_policy p = Parser::get_sched_policy(resetter);
+            std::cout << "==" << pid << "==  - " << (resetter ? "Resetter" : "Setter") << " thread policy: ";
+            if (p == sched_policy::p_inherit) std::cout << "inherited";
+            else if (p == sched_policy::p_other) std::cout << "other";
+            else if (p == sched_policy::p_batch) std::cout << "batch";
+            else if (p == sched_policy::p_idle) std::cout << "idle";
+            else if (p == sched_policy::p_fifo) std::cout << "fifo";
+            else if (p == sched_policy::p_rr) std::cout << "rr";
+            if (p == sched_policy::p_fifo || p == sched_policy::p_rr)
+                std::cout << ", priority " << Parser::get_sched_priority(resetter);
+            if (Parser::nice_is_set(resetter)) std::cout << ", nice " << Parser::get_nice(resetter);
+            std::cout << std::endl;
         }
-        std::cout << std::endl;
     }
 
     if (strat == strategy::proper) std::cout << "==" << pid << "== Strategy: proper" << std::endl;
@@ -0,0 +1,171 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for simulator.h.                                                  |
+|===========================================================================================================|
+*/
+
+#include <stdexcept>
+#include "adaptive.h"
+#include "ensemble.h"
+#include "parser.h"
+#include "prison.h"
+#include "progress.h"
+#include "records.h"
+#include "simulator.h"
+#include "trace.h"
+
+/**
+ * @brief MAIN METHOD - Runs every trial the configuration asks for, and reports what they came to.
+ *
+ * @details The configuration is copied and checked first, so settings that can't be used together are
+ * turned off the same way the program would (with a note printed, unless the run is silent). Nothing the
+ * run does changes the configuration or clocks in effect on the calling thread, except that the run's
+ * times are added to the calling thread's clocks once it is over, whether or not it succeeded.
+ *
+ * @param config Parameters of the run.
+ * @return Returns what the run came to.
+ * @throws std::runtime_error When the simulation can't be run as asked, such as when an output file can't
+ * be opened or the OS won't allow enough threads, or when the trace can't be written. Outputs opened by the
+ * run are closed first, and the records are always closed before the trace. Also thrown before anything
+ * runs when this run or another one going on uses the outputs of the whole process (see is_exclusive()).
+ */
+Results Simulator::run(const Config& config)
+{
+    Config settled = config;
+    Parser::check(settled, settled.output != out_mode::silent);
+    Timing::Clocks clocks;
+    Scope scope(&settled, &clocks);
+
+    Results results;
+    results.seed = settled.seed;
+    try {
+        Records::open();
+        Progress::start();
+        Trace::open();
+        Simulator::run_trials(&results);
+    } catch (...) {
+        Progress::stop();
+        Records::close();
+        try {
+            Trace::close();     // whatever was recorded may help find out what went wrong
+        } catch (const std::runtime_error&) {}  // the run's own error is the one worth reporting
+        throw;
+    }
+    Progress::stop();
+    Records::close();
+
+    for (uint8_t p = 0; p <= phase::ph_teardown; p++)
+        results.phase_seconds[p] = Timing::duration(static_cast<phase>(p));
+    Trace::close();
+    return results;
+}
+
+/**
+ * @brief CONSTRUCTOR - Counts a run as going on, and puts its configuration and clocks in effect on the
+ * calling thread.
+ *
+ * @param config Configuration of the run, already checked, which must outlive the scope.
+ * @param clocks Clocks of the run, which must outlive the scope.
+ * @throws std::runtime_error When the run uses outputs of the whole process while another run is going on,
+ * or when another run going on uses them.
+ */
+Simulator::Scope::Scope(const Config* config, Timing::Clocks* clocks)
+{
+    this->exclusive = Simulator::is_exclusive(*config);
+    {
+        std::lock_guard<std::mutex> guard(Simulator::runs_mutex);
+        if (Simulator::exclusive_run) throw std::runtime_error("Can't start a run while another run has "
+            "records, progress lines, a trace, or performance counters turned on, which belong to the "
+            "whole process");
+        if (this->exclusive && Simulator::runs > 0) throw std::runtime_error("Records, progress lines, "
+            "traces, and performance counters belong to the whole process, so they can't be turned on "
+            "while another run is going on");
+        Simulator::runs++;
+        Simulator::exclusive_run = this->exclusive;
+    }
+    this->outer_config = Parser::adopt(config);
+    this->outer_clocks = Timing::adopt(clocks);
+    this->run_clocks = clocks;
+}
+
+/**
+ * @brief DECONSTRUCTOR - Puts back the configuration and clocks that were in effect before the run, and adds
+ * the run's times to those clocks, even when the run is ending by an exception.
+ */
+Simulator::Scope::~Scope()
+{
+    Timing::adopt(this->outer_clocks);
+    Timing::absorb(*this->run_clocks);
+    Parser::adopt(this->outer_config);
+    std::lock_guard<std::mutex> guard(Simulator::runs_mutex);
+    Simulator::runs--;
+    if (this->exclusive) Simulator::exclusive_run = false;
+}
+
+/**
+ * @brief HELPER - Works out whether a run uses any of the outputs that belong to the whole process, which
+ * are kept in static state and can only serve one run at a time: records, progress lines, traces, and
+ * performance counters, which count every thread of the process.
+ *
+ * @param config Configuration of the run, already checked.
+ * @return Returns true if it does, false otherwise.
+ */
+bool Simulator::is_exclusive(const Config& config)
+{
+    return config.format != out_format::f_text || config.progress_ms > 0 || !config.trace_path.empty() ||
+        config.counters;
+}
+
+/**
+ * @brief HELPER - Runs the trials, either a fixed number of them or until the intervals are narrow enough,
+ * in the prison or side by side in the ensemble.
+ *
+ * @details The run's configuration and clocks must already be in effect on the calling thread.
+ *
+ * @param results Where to put what the trials came to.
+ */
+void Simulator::run_trials(Results* results)
+{
+    if (Parser::adaptive_is_on()) {
+        results->stats = Adaptive::run();
+        results->trials = results->stats.get_trials();
+        results->successes = results->stats.get_successes();
+        results->success = results->successes == results->trials;
+        return;
+    }
+
+    if (Parser::ensemble_is_on()) {
+        Ensemble ensemble(Parser::get_ensemble_mode(), Parser::get_number_of_prisoners());
+        ensemble.run(0, Parser::get_trials(), 0, &results->stats, &results->last);
+        results->trials = results->stats.get_trials();
+        results->successes = results->stats.get_successes();
+        results->success = results->successes == results->trials;
+        return;
+    }
+
+    uint32_t trials = Parser::get_trials();
+    bool initialized = false;
+    try {
+        for (uint32_t trial = 0; trial < trials; trial++) {
+            Timing::begin(phase::ph_init);
+            if (trial == 0) Prison::init();
+            else Prison::reset();
+            Timing::end(phase::ph_init);
+            initialized = true;
+            if (Prison::challenge()) results->successes++;
+            results->last = Prison::last_result();
+            results->stats.record(results->last);
+            Records::write(results->last, trial, 0);
+        }
+    } catch (...) {
+        if (initialized) Prison::free_memory();     // the prison is per thread, so don't leave it behind
+        throw;
+    }
+    results->trials = trials;
+    results->success = results->successes == trials;
+    Timing::begin(phase::ph_teardown);
+    Prison::free_memory();
+    Timing::end(phase::ph_teardown);
+}
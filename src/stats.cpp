@@ -0,0 +1,457 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for stats.h.                                                      |
+|===========================================================================================================|
+*/
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "stats.h"
+
+/**
+ * @brief SETTER - Adds one value to the running moments.
+ *
+ * @param x Value to add.
+ */
+void Welford::add(double x)
+{
+    if (this->count == 0 || x < this->min) this->min = x;
+    if (this->count == 0 || x > this->max) this->max = x;
+    this->count++;
+    double delta = x - this->mean;
+    this->mean += delta / static_cast<double>(this->count);
+    this->m2 += delta * (x - this->mean);
+}
+
+/**
+ * @brief SETTER - Folds another set of moments into this one, as if all its values had been added here.
+ *
+ * @param other Moments to merge in (Chan et al.'s parallel formula).
+ */
+void Welford::merge(const Welford& other)
+{
+    if (other.count == 0) return;
+    if (this->count == 0) {
+        *this = other;
+        return;
+    }
+    double n_a = static_cast<double>(this->count);
+    double n_b = static_cast<double>(other.count);
+    double delta = other.mean - this->mean;
+    this->count += other.count;
+    double n = static_cast<double>(this->count);
+    this->mean += delta * n_b / n;
+    this->m2 += other.m2 + delta * delta * n_a * n_b / n;
+    if (other.min < this->min) this->min = other.min;
+    if (other.max > this->max) this->max = other.max;
+}
+
+/**
+ * @brief GETTER - Interface for getting the number of values added.
+ *
+ * @return Returns the count.
+ */
+uint64_t Welford::get_count() const
+{
+    return this->count;
+}
+
+/**
+ * @brief GETTER - Interface for getting the mean of the values added.
+ *
+ * @return Returns the mean, or 0 if there are no values.
+ */
+double Welford::get_mean() const
+{
+    return this->mean;
+}
+
+/**
+ * @brief GETTER - Interface for getting the sample variance of the values added.
+ *
+ * @return Returns the unbiased sample variance, or 0 if there are fewer than 2 values.
+ */
+double Welford::get_variance() const
+{
+    return this->count > 1 ? this->m2 / static_cast<double>(this->count - 1) : 0.0;
+}
+
+/**
+ * @brief GETTER - Interface for getting the smallest value added.
+ *
+ * @return Returns the minimum, or 0 if there are no values.
+ */
+double Welford::get_min() const
+{
+    return this->min;
+}
+
+/**
+ * @brief GETTER - Interface for getting the largest value added.
+ *
+ * @return Returns the maximum, or 0 if there are no values.
+ */
+double Welford::get_max() const
+{
+    return this->max;
+}
+
+/**
+ * @brief CONSTRUCTOR - Initializes the object with no values.
+ */
+QuantileSketch::QuantileSketch() :
+    log_gamma(std::log1p(2.0 * QuantileSketch::ALPHA / (1.0 - QuantileSketch::ALPHA))) {}
+
+/**
+ * @brief HELPER - Finds the bucket a value belongs in.
+ *
+ * @param x Positive value.
+ * @return Returns the index i such that gamma^(i-1) < x <= gamma^i.
+ */
+int32_t QuantileSketch::index(double x) const
+{
+    return static_cast<int32_t>(std::ceil(std::log(x) / this->log_gamma));
+}
+
+/**
+ * @brief HELPER - Merges the lowest buckets together until there are few enough of them.
+ *
+ * @details This only loses accuracy at the very bottom of the distribution, which is not where the
+ * interesting quantiles are.
+ */
+void QuantileSketch::collapse()
+{
+    while (this->buckets.size() > QuantileSketch::MAX_BUCKETS) {
+        auto lowest = this->buckets.begin();
+        auto next = std::next(lowest);
+        next->second += lowest->second;
+        this->buckets.erase(lowest);
+    }
+}
+
+/**
+ * @brief SETTER - Adds one value to the sketch.
+ *
+ * @param x Value to add; anything not above 0 is only counted, and reads back as 0.
+ */
+void QuantileSketch::add(double x)
+{
+    this->count++;
+    if (!(x > 0.0)) {
+        this->zero_count++;
+        return;
+    }
+    this->buckets[this->index(x)]++;
+    if (this->buckets.size() > QuantileSketch::MAX_BUCKETS) this->collapse();
+}
+
+/**
+ * @brief SETTER - Folds another sketch into this one, as if all its values had been added here.
+ *
+ * @param other Sketch to merge in.
+ */
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    for (const auto& bucket : other.buckets) this->buckets[bucket.first] += bucket.second;
+    this->zero_count += other.zero_count;
+    this->count += other.count;
+    this->collapse();
+}
+
+/**
+ * @brief GETTER - Interface for getting the value that stands for every value in a bucket.
+ *
+ * @param i Index of the bucket.
+ * @return Returns the point within the bucket that is within the relative accuracy of both its bounds.
+ */
+double QuantileSketch::value(int32_t i) const
+{
+    double gamma = std::exp(this->log_gamma);
+    return 2.0 * std::exp(this->log_gamma * i) / (gamma + 1.0);
+}
+
+/**
+ * @brief GETTER - Interface for getting an approximate quantile.
+ *
+ * @param q Quantile to get, from 0 to 1.
+ * @return Returns a value within the relative accuracy of the true quantile, or 0 if there are no values.
+ */
+double QuantileSketch::quantile(double q) const
+{
+    if (this->count == 0) return 0.0;
+    double rank = q * static_cast<double>(this->count - 1);
+    uint64_t seen = this->zero_count;
+    if (static_cast<double>(seen) > rank) return 0.0;
+    for (const auto& bucket : this->buckets) {
+        seen += bucket.second;
+        if (static_cast<double>(seen) > rank) return this->value(bucket.first);
+    }
+    return this->value(this->buckets.rbegin()->first);
+}
+
+/**
+ * @brief GETTER - Interface for getting the number of values added.
+ *
+ * @return Returns the count.
+ */
+uint64_t QuantileSketch::get_count() const
+{
+    return this->count;
+}
+
+/**
+ * @brief GETTER - Interface for getting the number of values that were not above 0.
+ *
+ * @return Returns the count of such values.
+ */
+uint64_t QuantileSketch::get_zero_count() const
+{
+    return this->zero_count;
+}
+
+/**
+ * @brief GETTER - Interface for getting the buckets themselves, for drawing histograms.
+ *
+ * @return Returns the count of values per bucket index, in increasing order of index.
+ */
+const std::map<int32_t, uint64_t>& QuantileSketch::get_buckets() const
+{
+    return this->buckets;
+}
+
+/**
+ * @brief SETTER - Adds one value to the metric.
+ *
+ * @param x Value to add.
+ */
+void Statistic::add(double x)
+{
+    this->moments.add(x);
+    this->sketch.add(x);
+}
+
+/**
+ * @brief SETTER - Folds another metric's summary into this one.
+ *
+ * @param other Summary to merge in.
+ */
+void Statistic::merge(const Statistic& other)
+{
+    this->moments.merge(other.moments);
+    this->sketch.merge(other.sketch);
+}
+
+/**
+ * @brief GETTER - Interface for getting the exact moments of the metric.
+ *
+ * @return Returns a reference to the Welford accumulator.
+ */
+const Welford& Statistic::get_moments() const
+{
+    return this->moments;
+}
+
+/**
+ * @brief GETTER - Interface for getting an approximate quantile of the metric.
+ *
+ * @details The sketch's answer is clamped to the exact minimum and maximum, so p0 and p100 are exact.
+ *
+ * @param q Quantile to get, from 0 to 1.
+ * @return Returns the quantile, or 0 if there are no values.
+ */
+double Statistic::quantile(double q) const
+{
+    if (this->moments.get_count() == 0) return 0.0;
+    double x = this->sketch.quantile(q);
+    if (x < this->moments.get_min()) return this->moments.get_min();
+    if (x > this->moments.get_max()) return this->moments.get_max();
+    return x;
+}
+
+/**
+ * @brief HELPER - Prints a histogram of the metric, with bins spaced evenly on a log scale.
+ *
+ * @param bins Number of bins to draw between the smallest and the largest value.
+ */
+void Statistic::print_histogram(uint32_t bins) const
+{
+    const uint32_t WIDTH = 40;  // characters in the longest bar
+    double lo = this->moments.get_min();
+    double hi = this->moments.get_max();
+    if (this->moments.get_count() == 0 || bins == 0) return;
+    if (!(lo > 0.0) || !(hi > lo)) bins = 1;
+
+    std::vector<uint64_t> counts(bins, 0);
+    counts.at(0) += this->sketch.get_zero_count();
+    double span = bins > 1 ? std::log(hi / lo) : 1.0;
+    for (const auto& bucket : this->sketch.get_buckets()) {
+        uint32_t bin = 0;
+        if (bins > 1) {
+            double at = std::log(this->sketch.value(bucket.first) / lo) / span * bins;
+            bin = at <= 0.0 ? 0 : (at >= bins ? bins - 1 : static_cast<uint32_t>(at));
+        }
+        counts.at(bin) += bucket.second;
+    }
+    uint64_t most = 1;
+    for (uint64_t c : counts) if (c > most) most = c;
+
+    for (uint32_t bin = 0; bin < bins; bin++) {
+        double from = bins > 1 ? lo * std::exp(span * bin / bins) : lo;
+        double to = bins > 1 ? lo * std::exp(span * (bin + 1) / bins) : hi;
+        uint32_t bar = static_cast<uint32_t>(counts.at(bin) * WIDTH / most);
+        std::cout << "  [" << std::setw(12) << from << ", " << std::setw(12) << to << "] " <<
+            std::string(bar, '#') << std::string(WIDTH - bar, ' ') << " " << counts.at(bin) << std::endl;
+    }
+}
+
+/**
+ * @brief SETTER - Adds one challenge to the summary.
+ *
+ * @details The coverage metric only counts challenges in which everyone did get in at some point.
+ *
+ * @param result What the challenge came to.
+ */
+void TrialStats::record(const ChallengeResult& result)
+{
+    this->trials++;
+    if (result.success) this->successes++;
+    this->metrics[0].add(static_cast<double>(result.entries));
+    this->metrics[1].add(static_cast<double>(result.flips));
+    this->metrics[2].add(result.seconds);
+    if (result.coverage > 0) this->metrics[3].add(static_cast<double>(result.coverage));
+    this->metrics[4].add(result.cpu_seconds);
+    this->weighted_failures.add(result.success ? 0.0 : result.weight);
+}
+
+/**
+ * @brief SETTER - Folds another summary into this one, as if all its challenges had been recorded here.
+ *
+ * @param other Summary to merge in, typically from another worker.
+ */
+void TrialStats::merge(const TrialStats& other)
+{
+    this->trials += other.trials;
+    this->successes += other.successes;
+    for (uint8_t m = 0; m < TrialStats::NUM_METRICS; m++) this->metrics[m].merge(other.metrics[m]);
+    this->weighted_failures.merge(other.weighted_failures);
+}
+
+/**
+ * @brief GETTER - Interface for getting the number of challenges recorded.
+ *
+ * @return Returns the count.
+ */
+uint64_t TrialStats::get_trials() const
+{
+    return this->trials;
+}
+
+/**
+ * @brief GETTER - Interface for getting the number of challenges in which the claim was correct.
+ *
+ * @return Returns the count.
+ */
+uint64_t TrialStats::get_successes() const
+{
+    return this->successes;
+}
+
+/**
+ * @brief GETTER - Interface for getting the summary of room entries per challenge.
+ *
+ * @return Returns a reference to the statistic.
+ */
+const Statistic& TrialStats::get_entries() const
+{
+    return this->metrics[0];
+}
+
+/**
+ * @brief GETTER - Interface for getting the summary of switch flips per challenge.
+ *
+ * @return Returns a reference to the statistic.
+ */
+const Statistic& TrialStats::get_flips() const
+{
+    return this->metrics[1];
+}
+
+/**
+ * @brief GETTER - Interface for getting the summary of wall time per challenge.
+ *
+ * @return Returns a reference to the statistic.
+ */
+const Statistic& TrialStats::get_seconds() const
+{
+    return this->metrics[2];
+}
+
+/**
+ * @brief GETTER - Interface for getting the summary of the entry on which everyone had been in.
+ *
+ * @return Returns a reference to the statistic.
+ */
+const Statistic& TrialStats::get_coverage() const
+{
+    return this->metrics[3];
+}
+
+/**
+ * @brief GETTER - Interface for getting the summary of CPU time per challenge.
+ *
+ * @return Returns a reference to the statistic.
+ */
+const Statistic& TrialStats::get_cpu_seconds() const
+{
+    return this->metrics[4];
+}
+
+/**
+ * @brief GETTER - Interface for getting the weight of every trial that failed (and 0 for every success).
+ *
+ * @details The mean is an unbiased estimate of the failure probability, whether or not the trials were
+ * importance sampled; without it, every weight is 1 and the mean is just the fraction of failures.
+ *
+ * @return Returns a reference to the moments.
+ */
+const Welford& TrialStats::get_weighted_failures() const
+{
+    return this->weighted_failures;
+}
+
+/**
+ * @brief HELPER - Prints the summary: a row of moments and quantiles per metric, then a histogram of entries.
+ */
+void TrialStats::print() const
+{
+    const char* names[NUM_METRICS] = {"room entries", "switch flips", "wall seconds", "full coverage entry",
+        "CPU seconds"};
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << std::endl << "Summary of " << this->trials << " trials (quantiles within " <<
+        QuantileSketch::ALPHA * 100 << "%):" << std::endl << std::setprecision(6);
+    std::cout << "  " << std::left << std::setw(20) << "metric" << std::right;
+    for (const char* column : {"count", "mean", "std dev", "min", "p50", "p90", "p99", "p99.9", "max"})
+        std::cout << std::setw(12) << column;
+    std::cout << std::endl;
+    for (uint8_t m = 0; m < NUM_METRICS; m++) {
+        const Welford& moments = this->metrics[m].get_moments();
+        std::cout << "  " << std::left << std::setw(20) << names[m] << std::right << std::setw(12) <<
+            moments.get_count() << std::setw(12) << moments.get_mean() << std::setw(12) <<
+            std::sqrt(moments.get_variance()) << std::setw(12) << moments.get_min();
+        for (double q : quantiles) std::cout << std::setw(12) << this->metrics[m].quantile(q);
+        std::cout << std::setw(12) << moments.get_max() << std::endl;
+    }
+    std::cout << "Room entries per trial:" << std::endl;
+    this->metrics[0].print_histogram(10);
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
@@ -9,9 +9,14 @@ Isaac Jung
 #include <iostream>
 #include <thread>
 #include "global.h"
+#include "handoff.h"
 #include "parser.h"
 #include "prisoner.h"
+#include "processes.h"
+#include "progress.h"
 #include "switch.h"
+#include "timing.h"
+#include "trace.h"
 
 
 /*============================================= SwitchRoom ================================================*/
@@ -19,19 +24,53 @@ Isaac Jung
 /**
  * @brief CONSTRUCTOR - Initializes the object.
  *
- * @param initial_state Initial state of the room's switch, on or off.
+ * @param initial_position Initial position of the room's switch, from 0 (off) to RoomSwitch::TOP.
+ * @param number_of_prisoners Number of prisoners who could visit, for noticing when all of them have.
  */
-SwitchRoom::SwitchRoom(switch_state initial_state)
+SwitchRoom::SwitchRoom(uint8_t initial_position, uint32_t number_of_prisoners) : s(initial_position),
+    population(number_of_prisoners) {}
+
+/**
+ * @brief DECONSTRUCTOR - Nothing to free, since the switch is held by value.
+ */
+SwitchRoom::~SwitchRoom() {}
+
+/**
+ * @brief SETTER - Makes the room use directed handoff instead of its own mutex.
+ *
+ * @details Must be called before any prisoner tries to unlock the room. The room does not take ownership.
+ *
+ * @param h Handoff object deciding who gets in next, or nullptr to go back to using the mutex.
+ */
+void SwitchRoom::set_handoff(Handoff* h)
+{
+    this->handoff = h;
+}
+
+/**
+ * @brief SETTER - Makes the room use a lock shared between processes instead of its own mutex.
+ *
+ * @details Must be called before any prisoner tries to unlock the room. The room does not take ownership.
+ *
+ * @param k Lock in the same shared memory as the room, or nullptr to go back to using the mutex.
+ */
+void SwitchRoom::set_process_key(ProcessKey* k)
 {
-    this->s = new Switch(initial_state);
+    this->process_key = k;
 }
 
 /**
- * @brief DECONSTRUCTOR - Frees memory.
+ * @brief SETTER - Makes the room number its entries in a sequence shared with the prison's other rooms.
+ *
+ * @details Must be called before any prisoner tries to unlock the room. Without it, the room's entries are
+ * numbered by its own count, which is only the prison's when there is a single room. The room does not take
+ * ownership.
+ *
+ * @param q Count of the entries into every room, which must be in the same memory as the room.
  */
-SwitchRoom::~SwitchRoom()
+void SwitchRoom::set_sequence(std::atomic<uint64_t>* q)
 {
-    delete this->s;
+    this->sequence = q;
 }
 
 /**
@@ -41,7 +80,7 @@ SwitchRoom::~SwitchRoom()
  * Once they are done being in the room, they should be sure to call the lock() method to lock the door
  * behind them. If they don't no other prisoner will be allowed to enter the room.
  * This method is thread safe. When multiple threads try to call it at once, they will simply get stuck at
- * the door, and the OS will decide who gets in.
+ * the door, and the OS will decide who gets in (or, under the handoff warden, the prisoner leaving will).
  *
  * @param prisoner Prisoner trying to unlock the room.
  */
@@ -53,7 +92,12 @@ void SwitchRoom::unlock(Prisoner* prisoner)
     if (Parser::verbose_is_on()) std::cout << std::endl << prisoner->to_string() <<
         " is trying to unlock the room." << std::endl;
     Global::output_mutex.unlock();
-    this->key.lock();
+    TRACE_BEGIN("waiting for the room");
+    if (this->handoff != nullptr) this->handoff->acquire(prisoner->get_index());
+    else if (this->process_key != nullptr) this->process_key->lock();
+    else this->key.lock();
+    TRACE_END("waiting for the room");
+    TRACE_BEGIN("in the room");
     this->current_occupant = prisoner;
     if (Parser::verbose_is_on()) {
         Global::output_mutex.lock();
@@ -76,6 +120,11 @@ void SwitchRoom::enter(Prisoner* prisoner)
     if (prisoner != this->current_occupant) return;
     prisoner->set_in_switch_room(true);
     this->entered_count++;
+    uint64_t entry = this->sequence != nullptr ?   // which entry of the whole prison this is
+        this->sequence->fetch_add(1, std::memory_order_relaxed) + 1 : this->entered_count;
+    if (this->entered_count == 1) Timing::mark_first_entry();
+    if (prisoner->get_entered_count() == 1 && ++this->distinct_visitors == this->population)
+        this->coverage_entry = entry;
     if (Parser::get_output_mode() != out_mode::silent) {
         Global::output_mutex.lock();
         std::cout << std::endl << prisoner->to_string() << " has entered the room." << std::endl;
@@ -84,42 +133,49 @@ void SwitchRoom::enter(Prisoner* prisoner)
 }
 
 /**
- * @brief GETTER - Interface for getting the current switch state.
+ * @brief GETTER - Interface for getting the current position of the switch.
  *
- * @details This method will not return anything meaningful unless the prisoner is in the room. That means
- * that the enter() method must be called before this one.
+ * @details This method will not tell the prisoner anything unless they are in the room. That means that the
+ * enter() method must be called before this one.
  *
  * @param prisoner Prisoner trying to inspect the switch.
- * @return Returns a switch state - unknown when the prisoner is not allowed to know, otherwise on or off.
+ * @param position Set to the position of the switch, from 0 (off) to RoomSwitch::TOP, when allowed.
+ * @return Returns false when the prisoner is not allowed to know, true otherwise.
  */
-switch_state SwitchRoom::check_switch(Prisoner* prisoner)
+bool SwitchRoom::check_switch(Prisoner* prisoner, uint8_t* position)
 {
-    if (prisoner != this->current_occupant || !prisoner->is_in_switch_room()) return unknown;
+    if (prisoner != this->current_occupant || !prisoner->is_in_switch_room()) return false;
     if (Parser::verbose_is_on() && Parser::get_output_mode() == out_mode::normal) {
         Global::output_mutex.lock();
         std::cout << "  --> They check the switch." << std::endl;
         Global::output_mutex.unlock();
     }
-    return this->s->is_on() ? switch_state::on : switch_state::off;
+    *position = this->s.get_position();
+    return true;
 }
 
 /**
- * @brief TOGGLER - Interface for flipping the switch from off to on or vice versa.
+ * @brief TOGGLER - Interface for turning the switch to another position; with 2 positions, this flips it
+ * from off to on or vice versa.
  *
  * @details This method will do nothing if the prisoner is not currently in the room. That means that the
  * enter() method must be called before this one.
  *
- * @param prisoner Prisoner trying to flip the switch.
+ * @param prisoner Prisoner trying to turn the switch.
+ * @param to New position of the switch, from 0 (off) to RoomSwitch::TOP.
  */
-void SwitchRoom::flip_switch(Prisoner* prisoner)
+void SwitchRoom::turn_switch(Prisoner* prisoner, uint8_t to)
 {
     if (prisoner != this->current_occupant || !prisoner->is_in_switch_room()) return;
-    this->s->flip();
+    uint8_t from = this->s.get_position();
+    this->s.turn(to);
     this->flipped_count++;
     if (Parser::get_output_mode() == out_mode::normal) {
         Global::output_mutex.lock();
-        std::cout << "  --> They flip the switch to the " << (this->s->is_on() ? "on" : "off") <<
-            " state." << std::endl;
+        if (Global::POSITIONS == 2) std::cout << "  --> They flip the switch to the " <<
+            (to > 0 ? "on" : "off") << " state." << std::endl;
+        else std::cout << "  --> They turn the switch from position " << +from << " to position " << +to <<
+            "." << std::endl;
         Global::output_mutex.unlock();
     }
 }
@@ -163,8 +219,34 @@ void SwitchRoom::lock(Prisoner* prisoner)
         std::cout << "  --> They lock the room behind them." << std::endl;
         Global::output_mutex.unlock();
     }
+    if (Parser::progress_is_on())
+        Progress::publish(this->entered_count, this->flipped_count, this->distinct_visitors, prisoner);
     this->current_occupant = nullptr;
-    this->key.unlock();
+    TRACE_END("in the room");
+    if (this->handoff != nullptr) this->handoff->release(prisoner->get_index());
+    else if (this->process_key != nullptr) this->process_key->unlock();
+    else this->key.unlock();
+}
+
+/**
+ * @brief SETTER - Records that a prisoner will not come back to the room until the challenge is over.
+ *
+ * @details Must be called while the prisoner still holds the room, right before lock(), so that the count is
+ * protected by the same lock as the rest of the room's state. A parked prisoner has already been counted as
+ * having visited, so skipping the visits they would have made changes no outcome, though it does leave them
+ * out of the entry count; the time they spend parked is recorded by Threading::park_wait() instead.
+ *
+ * @param prisoner Prisoner who is about to park.
+ */
+void SwitchRoom::park(Prisoner* prisoner)
+{
+    if (prisoner != this->current_occupant) return;
+    this->parked_count++;
+    if (Parser::verbose_is_on()) {
+        Global::output_mutex.lock();
+        std::cout << "  --> They are done, so they stop visiting until the challenge is over." << std::endl;
+        Global::output_mutex.unlock();
+    }
 }
 
 /**
@@ -187,33 +269,35 @@ uint32_t SwitchRoom::get_flipped_count()
     return this->flipped_count;
 }
 
-
-/*=============================================== Switch ==================================================*/
-
 /**
- * @brief CONSTRUCTOR - Initializes the object.
+ * @brief GETTER - Interface for getting how many finished setters parked instead of visiting again.
  *
- * @param initial_state Initial state of the switch, on or off. Note that it should never be unknown.
+ * @return Returns an integer greater than or equal to 0.
  */
-Switch::Switch(switch_state initial_state)
+uint32_t SwitchRoom::get_parked_count()
 {
-    this->state = initial_state;
+    return this->parked_count;
 }
 
 /**
- * @brief GETTER - Checks whether the switch is on.
+ * @brief GETTER - Interface for getting the entry on which every prisoner of the room had been in at least
+ * once.
  *
- * @return Returns true if the switch is on, false otherwise.
+ * @return Returns the number of the entry into the prison (counting every room, if they share a sequence)
+ * on which the room's last prisoner first got in, or 0 if some prisoner still hasn't.
  */
-bool Switch::is_on()
+uint64_t SwitchRoom::get_coverage_entry()
 {
-    return this->state == switch_state::on;
+    return this->coverage_entry;
 }
 
 /**
- * @brief TOGGLER - Flips the switch state from off to on or vice versa.
+ * @brief GETTER - Interface for getting how many times a prisoner got into the room after the prisoner
+ * inside died, which can only happen under the process warden.
+ *
+ * @return Returns an integer greater than or equal to 0.
  */
-void Switch::flip()
+uint32_t SwitchRoom::get_recovered_count()
 {
-    this->state = (this->state == switch_state::off) ? switch_state::on : switch_state::off;
+    return this->process_key != nullptr ? this->process_key->get_recovered_count() : 0;
 }
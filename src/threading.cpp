@@ -0,0 +1,369 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for threading.h.                                                  |
+|===========================================================================================================|
+*/
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include "global.h"
+#include "parser.h"
+#include "threading.h"
+
+/**
+ * @brief SUB METHOD - A prisoner thread should call this on itself before performing its task.
+ *
+ * @details Applies the scheduling policy, real-time priority, and nice value given on the command line to
+ * the calling thread only. When nothing was given, the thread is left exactly as the OS created it. The
+ * nice value is applied per thread, which Linux allows through setpriority() on the thread ID.
+ *
+ * @param resetter Use true when the calling thread belongs to the resetter, which may have its own settings.
+ */
+void Threading::apply_scheduling(bool resetter)
+{
+    sched_policy policy = Parser::get_sched_policy(resetter);
+    if (policy != sched_policy::p_inherit) {
+        int32_t native = Threading::to_native_policy(policy);
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        if (policy == sched_policy::p_fifo || policy == sched_policy::p_rr) {
+            param.sched_priority = Parser::get_sched_priority(resetter);
+            int32_t min = sched_get_priority_min(native);
+            int32_t max = sched_get_priority_max(native);
+            if (param.sched_priority < min) param.sched_priority = min;
+            else if (param.sched_priority > max) param.sched_priority = max;
+        }
+        int32_t err = pthread_setschedparam(pthread_self(), native, &param);
+        if (err != 0) Threading::warn(refusal::r_policy, "could not switch prisoner threads to " +
+            Threading::policy_name(native) + " (" + std::strerror(err) + "); using the inherited policy");
+    }
+    if (Parser::nice_is_set(resetter)) {
+        int32_t nice = Parser::get_nice(resetter);
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), nice) != 0)
+            Threading::warn(refusal::r_nice, "could not set the nice value of prisoner threads to " +
+                std::to_string(nice) + " (" + std::strerror(errno) + "); using the inherited value");
+    }
+}
+
+/**
+ * @brief SUB METHOD - A prisoner thread may call this on itself to be pinned to a single CPU.
+ *
+ * @details CPUs are handed out round robin among those the process is allowed to run on, so that threads
+ * are spread evenly. A refusal is reported once per challenge and otherwise ignored.
+ *
+ * @param ticket Creation order of the calling thread, used to pick its CPU.
+ */
+void Threading::pin(uint32_t ticket)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    int32_t count = CPU_COUNT(&allowed);
+    if (count <= 0) return;
+    uint32_t target = ticket % static_cast<uint32_t>(count);
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) continue;
+        if (target-- > 0) continue;
+        cpu_set_t mine;
+        CPU_ZERO(&mine);
+        CPU_SET(cpu, &mine);
+        int32_t err = pthread_setaffinity_np(pthread_self(), sizeof(mine), &mine);
+        if (err != 0) Threading::warn(refusal::r_pin, "could not pin prisoner threads to CPUs (" +
+            std::string(std::strerror(err)) + "); letting the OS place them");
+        return;
+    }
+}
+
+/**
+ * @brief SETTER - Makes the calling thread use the given start gate and parking lot.
+ *
+ * @details The thread starting a challenge creates fresh gates for it, and every prisoner thread of that
+ * challenge adopts them before doing anything else. The gates are not copied, so they must outlive their use.
+ *
+ * @param challenge Gates to use, or nullptr for none.
+ * @return Returns the gates used before, so that they can be put back.
+ */
+Threading::Gates* Threading::adopt(Gates* challenge)
+{
+    Gates* previous = Threading::gates;
+    Threading::gates = challenge;
+    return previous;
+}
+
+/**
+ * @brief SEMAPHORE - A prisoner thread calls this to park at the start gate until its ticket is released.
+ *
+ * @param ticket Creation order of the calling thread, from 0 to the number of threads - 1.
+ */
+void Threading::gate_wait(uint32_t ticket)
+{
+    Gates* g = Threading::gates;
+    std::unique_lock<std::mutex> lock(g->gate_mutex);
+    g->arrived++;
+    g->gate_cv.notify_all();
+    g->gate_cv.wait(lock, [g, ticket]() { return g->released > ticket; });
+}
+
+/**
+ * @brief SEMAPHORE - The main thread calls this to wait until every prisoner thread is parked at the gate.
+ *
+ * @param count Number of threads that were created.
+ */
+void Threading::gate_await(uint32_t count)
+{
+    Gates* g = Threading::gates;
+    std::unique_lock<std::mutex> lock(g->gate_mutex);
+    g->gate_cv.wait(lock, [g, count]() { return g->arrived >= count; });
+}
+
+/**
+ * @brief SEMAPHORE - The main thread calls this to let the parked prisoner threads go.
+ *
+ * @param count Number of threads that were created.
+ * @param stagger Microseconds to wait between releasing consecutive tickets; 0 or less releases everyone at
+ *  once.
+ */
+void Threading::gate_release(uint32_t count, int32_t stagger)
+{
+    Gates* g = Threading::gates;
+    if (stagger <= 0) {
+        std::lock_guard<std::mutex> guard(g->gate_mutex);
+        g->released = count;
+        g->gate_cv.notify_all();
+        return;
+    }
+    for (uint32_t ticket = 1; ticket <= count; ticket++) {
+        {
+            std::lock_guard<std::mutex> guard(g->gate_mutex);
+            g->released = ticket;
+        }
+        g->gate_cv.notify_all();
+        if (ticket < count) std::this_thread::sleep_for(std::chrono::microseconds(stagger));
+    }
+}
+
+/**
+ * @brief SEMAPHORE - A prisoner thread calls this to sleep until the challenge is over.
+ *
+ * @details Returns immediately if park_release() was already called, so a thread can never miss the end.
+ * The time spent parked is added to the parking lot's total, since the visits the thread skipped meanwhile
+ * are not in the room's entry count.
+ */
+void Threading::park_wait()
+{
+    Gates* g = Threading::gates;
+    auto parked = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(g->park_mutex);
+    g->park_cv.wait(lock, [g]() { return g->park_open; });
+    g->parked_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - parked).count());
+}
+
+/**
+ * @brief SEMAPHORE - Wakes every parked thread, and lets any thread that parks later through at once.
+ */
+void Threading::park_release()
+{
+    Gates* g = Threading::gates;
+    if (g == nullptr) return;  // not in a threaded challenge, so nobody can be parked
+    {
+        std::lock_guard<std::mutex> guard(g->park_mutex);
+        g->park_open = true;
+    }
+    g->park_cv.notify_all();
+}
+
+/**
+ * @brief GETTER - Works out about how many more threads the OS will let this process create.
+ *
+ * @details Best effort, since other processes share some of these limits. Checks the per user limit on
+ * processes and threads (RLIMIT_NPROC, not enforced for root), the system wide threads-max, the number of
+ * memory mappings a process may have (every thread stack takes two, one of them its guard page), and the
+ * available memory. Stacks only use the pages they touch, so a thread is assumed to need THREAD_MEMORY,
+ * unless the system is set to never overcommit, in which case its whole stack counts too.
+ *
+ * @param stack_bytes Stack size each thread will get.
+ * @param limit Set to a description of the tightest limit, left alone if none could be read.
+ * @return Returns the number of threads, or UINT64_MAX if no limit could be read.
+ */
+uint64_t Threading::thread_capacity(size_t stack_bytes, std::string* limit)
+{
+    uint64_t capacity = UINT64_MAX;
+    uint64_t running = Threading::read_number("/proc/self/status", "Threads:");
+    auto consider = [&](uint64_t allowed, uint64_t used, const std::string& name) {
+        uint64_t left = allowed > used ? allowed - used : 0;
+        if (left < capacity) {
+            capacity = left;
+            *limit = name;
+        }
+    };
+
+    rlimit nproc;
+    if (geteuid() != 0 && getrlimit(RLIMIT_NPROC, &nproc) == 0 && nproc.rlim_cur != RLIM_INFINITY)
+        consider(nproc.rlim_cur, running, "the limit on processes per user (ulimit -u)");
+    uint64_t threads_max = Threading::read_number("/proc/sys/kernel/threads-max");
+    if (threads_max > 0) consider(threads_max, running, "the system's limit on threads (kernel.threads-max)");
+    uint64_t max_maps = Threading::read_number("/proc/sys/vm/max_map_count");
+    if (max_maps > 0) {
+        uint64_t maps = 0;
+        std::ifstream file("/proc/self/maps");
+        for (std::string line; std::getline(file, line);) maps++;
+        consider(max_maps / 2, maps / 2, "the limit on memory mappings (vm.max_map_count)");
+    }
+    uint64_t available = Threading::read_number("/proc/meminfo", "MemAvailable:") * 1024;
+    if (available > 0) {
+        uint64_t each = Threading::THREAD_MEMORY;
+        if (Threading::read_number("/proc/sys/vm/overcommit_memory") == 2) each += stack_bytes;
+        consider(available / each, 0, "the available memory");
+    }
+    return capacity;
+}
+
+/**
+ * @brief INITIALIZER - Starts a thread with a stack of the given size.
+ *
+ * @param thread Where to store the new thread, to be joined with pthread_join().
+ * @param task What the thread should run; must stay alive until the thread has been joined.
+ * @param stack_bytes Size of the thread's stack, rounded up to a whole number of pages.
+ * @return Returns 0 on success, otherwise the error from pthread_create().
+ */
+int32_t Threading::spawn(pthread_t* thread, std::function<void()>* task, size_t stack_bytes)
+{
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    stack_bytes = (stack_bytes + page - 1) / page * page;
+    size_t least = static_cast<size_t>(PTHREAD_STACK_MIN);
+    if (stack_bytes < least) stack_bytes = least;
+
+    pthread_attr_t attributes;
+    int32_t err = pthread_attr_init(&attributes);
+    if (err != 0) return err;
+    err = pthread_attr_setstacksize(&attributes, stack_bytes);
+    if (err == 0) err = pthread_create(thread, &attributes, Threading::run_task, task);
+    pthread_attr_destroy(&attributes);
+    return err;
+}
+
+/**
+ * @brief GETTER - Interface for getting a readable name for a native scheduling policy.
+ *
+ * @param native_policy Policy as returned by sched_getscheduler() or pthread_getschedparam().
+ * @return Returns a string naming the policy, or "Unknown" when it is not recognized.
+ */
+std::string Threading::policy_name(int32_t native_policy)
+{
+    switch (native_policy) {
+        case SCHED_FIFO:
+            return "SCHED_FIFO (First In, First Out)";
+        case SCHED_RR:
+            return "SCHED_RR (Round Robin)";
+        case SCHED_OTHER:
+            return "SCHED_OTHER (Completely Fair Scheduler - CFS)";
+        case SCHED_BATCH:
+            return "SCHED_BATCH (CFS, treated as CPU-bound)";
+        case SCHED_IDLE:
+            return "SCHED_IDLE (Very low priority background)";
+        default:
+            return "Unknown";
+    }
+}
+
+/**
+ * @brief HELPER - Translates a sched_policy from enums.h into the value the OS understands.
+ *
+ * @param policy Any policy except p_inherit, which has no native equivalent.
+ * @return Returns one of the SCHED_* constants from sched.h.
+ */
+int32_t Threading::to_native_policy(sched_policy policy)
+{
+    switch (policy) {
+        case sched_policy::p_batch:
+            return SCHED_BATCH;
+        case sched_policy::p_idle:
+            return SCHED_IDLE;
+        case sched_policy::p_fifo:
+            return SCHED_FIFO;
+        case sched_policy::p_rr:
+            return SCHED_RR;
+        case sched_policy::p_inherit:
+        case sched_policy::p_other:
+        default:
+            return SCHED_OTHER;
+    }
+}
+
+/**
+ * @brief SETTER - Keeps refused scheduling requests from being reported by the calling process at all.
+ *
+ * @details Every prisoner process applies the same settings, but each has its own memory, so only the first
+ * of them should report what the OS refused; the others call this first.
+ */
+void Threading::hush()
+{
+    Threading::hushed = true;
+}
+
+/**
+ * @brief HELPER - Prints a note about a refused scheduling request, but only the first time that kind of
+ * request is refused in the calling thread's challenge.
+ *
+ * @details Every prisoner thread applies the same settings, so without this the same refusal would be
+ * printed once per prisoner. A thread without gates, such as a prisoner process, reports every refusal.
+ *
+ * @param kind Which kind of request was refused.
+ * @param message Description of what the OS refused.
+ */
+void Threading::warn(refusal kind, const std::string& message)
+{
+    if (Threading::hushed) return;
+    if (Threading::gates != nullptr && Threading::gates->warned[kind].exchange(true)) return;
+    Global::output_mutex.lock();
+    std::cout << "NOTE: " << message << std::endl;
+    Global::output_mutex.unlock();
+}
+
+/**
+ * @brief HELPER - Reads a number from a file in /proc.
+ *
+ * @param path File to read.
+ * @param key Label on the line holding the number, such as "Threads:", or empty for the first number.
+ * @return Returns the number, or 0 if the file or the label could not be found.
+ */
+uint64_t Threading::read_number(const std::string& path, const std::string& key)
+{
+    std::ifstream file(path);
+    std::string word;
+    while (file >> word) {
+        if (!key.empty() && word != key) continue;
+        uint64_t number = 0;
+        if (key.empty()) {
+            try {
+                number = std::stoull(word);
+            } catch (...) {
+                return 0;
+            }
+        } else file >> number;
+        return number;
+    }
+    return 0;
+}
+
+/**
+ * @brief SUB METHOD - Every thread made by spawn() starts here, and runs its task.
+ *
+ * @param task Pointer to the std::function given to spawn().
+ * @return Returns nullptr.
+ */
+void* Threading::run_task(void* task)
+{
+    (*static_cast<std::function<void()>*>(task))();
+    return nullptr;
+}
@@ -0,0 +1,179 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for timing.h.                                                     |
+|===========================================================================================================|
+*/
+
+#include <iomanip>
+#include <iostream>
+#include "global.h"
+#include "timing.h"
+
+Timing::Clocks Timing::process;    // defined here, since Clocks isn't complete inside Timing
+
+/**
+ * @brief GETTER - Interface for getting the clocks the calling thread records its times in.
+ *
+ * @return Returns them, for handing to the threads it starts.
+ */
+Timing::Clocks* Timing::current()
+{
+    return Timing::clocks;
+}
+
+/**
+ * @brief SETTER - Makes the calling thread record its times in the given clocks.
+ *
+ * @details Every thread starts out recording in clocks shared by the whole process. The clocks are not
+ * copied, so they must outlive their use.
+ *
+ * @param run Clocks to record in.
+ * @return Returns the clocks recorded in before, so that they can be put back.
+ */
+Timing::Clocks* Timing::adopt(Clocks* run)
+{
+    Clocks* previous = Timing::clocks;
+    Timing::clocks = run;
+    return previous;
+}
+
+/**
+ * @brief SETTER - Adds the times of a finished run to the calling thread's clocks.
+ *
+ * @details Phase totals add up, while the two events are taken from the run, since they describe its last
+ * trial.
+ *
+ * @param run Clocks of the finished run.
+ */
+void Timing::absorb(const Clocks& run)
+{
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    Clocks* c = Timing::clocks;
+    for (uint8_t p = 0; p < NUM_PHASES; p++) c->totals[p].fetch_add(run.totals[p].load(relaxed), relaxed);
+    c->spawn_began.store(run.spawn_began.load(relaxed), relaxed);
+    c->first_entry.store(run.first_entry.load(relaxed), relaxed);
+    c->last_thread_start.store(run.last_thread_start.load(relaxed), relaxed);
+}
+
+/**
+ * @brief SETTER - Records the beginning of a phase.
+ *
+ * @details Beginning the spawn phase also clears the first entry and last thread start events, since both
+ * are measured relative to it.
+ *
+ * @param p Phase that is beginning.
+ */
+void Timing::begin(phase p)
+{
+    Timing::begins[p] = clock::now();
+    if (p == phase::ph_spawn) {
+        Timing::clocks->spawn_began.store(Timing::begins[p].time_since_epoch().count(),
+            std::memory_order_relaxed);
+        Timing::clocks->first_entry.store(-1, std::memory_order_relaxed);
+        Timing::clocks->last_thread_start.store(-1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief SETTER - Records the end of a phase, adding its duration to the phase's total.
+ *
+ * @param p Phase that is ending.
+ */
+void Timing::end(phase p)
+{
+    clock::duration elapsed = clock::now() - Timing::begins[p];
+    Timing::clocks->totals[p].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+}
+
+/**
+ * @brief SETTER - Records the first entry into the switch room; later calls are ignored.
+ */
+void Timing::mark_first_entry()
+{
+    int64_t expected = -1;
+    Timing::clocks->first_entry.compare_exchange_strong(expected, Timing::since_spawn(),
+        std::memory_order_relaxed);
+}
+
+/**
+ * @brief SETTER - Records that a prisoner thread has started running. Keeps the latest such moment.
+ *
+ * @details This is thread safe; every prisoner thread should call it once, as the first thing it does.
+ */
+void Timing::mark_thread_start()
+{
+    int64_t now = Timing::since_spawn();
+    int64_t latest = Timing::clocks->last_thread_start.load(std::memory_order_relaxed);
+    while (now > latest &&
+        !Timing::clocks->last_thread_start.compare_exchange_weak(latest, now, std::memory_order_relaxed)) {}
+}
+
+/**
+ * @brief GETTER - Interface for getting how long a phase took, summed over every time it happened.
+ *
+ * @param p Phase to ask about.
+ * @return Returns the duration in seconds, or 0 if the phase has not happened.
+ */
+double Timing::duration(phase p)
+{
+    int64_t total = Timing::clocks->totals[p].load(std::memory_order_relaxed);
+    return Timing::seconds(std::chrono::nanoseconds(total));
+}
+
+/**
+ * @brief SUB METHOD - Prints the duration of every phase, along with the first entry and last thread start.
+ */
+void Timing::print()
+{
+    const char* names[NUM_PHASES] = {"parse", "init", "spawn", "contest", "verify", "teardown"};
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << std::endl << "Phase timing (seconds; " << (Global::PACKED ? "packed" : "cache-aligned") <<
+        " layout):" << std::endl << std::fixed << std::setprecision(9);
+    double total = 0.0;
+    for (uint8_t p = 0; p < NUM_PHASES; p++) {
+        double d = Timing::duration(static_cast<phase>(p));
+        total += d;
+        std::cout << "  " << std::left << std::setw(30) << names[p] << std::right << std::setw(16) << d <<
+            std::endl;
+    }
+    std::cout << "  " << std::left << std::setw(30) << "total" << std::right << std::setw(16) << total <<
+        std::endl;
+    int64_t first = Timing::clocks->first_entry.load(std::memory_order_relaxed);
+    int64_t last = Timing::clocks->last_thread_start.load(std::memory_order_relaxed);
+    if (first >= 0 || last >= 0) std::cout << "Events (seconds after spawn began):" << std::endl;
+    if (first >= 0) std::cout << "  " << std::left << std::setw(30) << "first room entry" << std::right <<
+        std::setw(16) << static_cast<double>(first) / 1e9 << std::endl;
+    if (last >= 0) std::cout << "  " << std::left << std::setw(30) << "last thread started running" <<
+        std::right << std::setw(16) << static_cast<double>(last) / 1e9 << std::endl;
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+/**
+ * @brief HELPER - Gets the time since the spawn phase began.
+ *
+ * @return Returns a number of nanoseconds.
+ */
+int64_t Timing::since_spawn()
+{
+    clock::duration elapsed = clock::now() -
+        clock::time_point(clock::duration(Timing::clocks->spawn_began.load(std::memory_order_relaxed)));
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+/**
+ * @brief HELPER - Converts a clock duration to seconds.
+ *
+ * @param duration Any duration from the steady clock.
+ * @return Returns the duration as a floating point number of seconds.
+ */
+double Timing::seconds(clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
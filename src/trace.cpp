@@ -0,0 +1,144 @@
+/* 100-Prisoners-1-Switch-Problem 
+Isaac Jung
+
+|===========================================================================================================|
+|   This file contains method definitions for trace.h.                                                      |
+|===========================================================================================================|
+*/
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include "global.h"
+#include "parser.h"
+#include "trace.h"
+
+/**
+ * @brief INITIALIZER - Turns tracing on when "--trace" was given, and starts the trace's clock.
+ *
+ * @details Must be called before any threads are started. The trace file is opened right away, so that a
+ * path that can't be written to is found before the run rather than after it. In a build with the trace
+ * points compiled out, this only notes that the option has no effect.
+ *
+ * @throws std::runtime_error When the trace file can't be opened.
+ */
+void Trace::open()
+{
+    Trace::path = Parser::get_trace_path();
+    if (Trace::path.empty()) return;
+#ifdef NO_TRACE
+    std::cout << "NOTE: this build has tracing compiled out; --trace ignored" << std::endl;
+    Trace::path.clear();
+#else
+    Trace::file.open(Trace::path, std::ios::out | std::ios::trunc);
+    if (!Trace::file.is_open()) throw std::runtime_error("Could not open trace file " + Trace::path);
+    Trace::opened = clock::now();
+    Trace::generation++;        // buffers left from an earlier trace are gone, whichever thread held them
+    Trace::enabled = true;
+    Trace::name_thread("main");
+#endif
+}
+
+/**
+ * @brief SETTER - Records that the calling thread began doing something.
+ *
+ * @param name What it began doing; must be a string literal.
+ */
+void Trace::begin(const char* name)
+{
+    Trace::record(name, 'B');
+}
+
+/**
+ * @brief SETTER - Records that the calling thread stopped doing something.
+ *
+ * @param name What it stopped doing; must be the same string given to begin().
+ */
+void Trace::end(const char* name)
+{
+    Trace::record(name, 'E');
+}
+
+/**
+ * @brief SETTER - Gives the calling thread a name for the viewer to show.
+ *
+ * @param name Name of the thread, such as the prisoner it belongs to.
+ */
+void Trace::name_thread(const std::string& name)
+{
+    Trace::get_local()->thread_name = name;
+}
+
+/**
+ * @brief DELETER - Writes every thread's events to the trace file as Chrome trace-event JSON, and frees them.
+ *
+ * @details Must only be called once every traced thread has finished.
+ *
+ * @throws std::runtime_error When the trace file can't be written.
+ */
+void Trace::close()
+{
+    if (!Trace::enabled) return;
+    Trace::enabled = false;
+
+    std::ofstream& out = Trace::file;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << Global::PID <<
+        ",\"tid\":0,\"args\":{\"name\":\"simulation\"}}";
+    uint64_t dropped = 0;
+    std::lock_guard<std::mutex> guard(Trace::m);
+    for (const std::unique_ptr<Buffer>& buffer : Trace::buffers) {
+        if (!buffer->thread_name.empty()) out << "," << std::endl << "{\"name\":\"thread_name\"," <<
+            "\"ph\":\"M\",\"pid\":" << Global::PID << ",\"tid\":" << buffer->tid <<
+            ",\"args\":{\"name\":\"" << buffer->thread_name << "\"}}";
+        for (const Event& event : buffer->events)   // ts is in microseconds
+            out << "," << std::endl << "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase <<
+                "\",\"pid\":" << Global::PID << ",\"tid\":" << buffer->tid << ",\"ts\":" <<
+                static_cast<double>(event.time) / 1000.0 << "}";
+        dropped += buffer->dropped;
+    }
+    out << std::endl << "]}" << std::endl;
+    out.close();
+    Trace::buffers.clear();
+    if (dropped > 0) std::cout << "NOTE: the trace was full for some threads; " << dropped <<
+        " events were dropped" << std::endl;
+    if (out.fail()) throw std::runtime_error("Could not write trace file " + Trace::path);
+}
+
+/**
+ * @brief HELPER - Gets the calling thread's buffer, creating it on the thread's first event of the trace.
+ *
+ * @details A thread may still point at a buffer from an earlier trace, which close() has freed, so the
+ * pointer is only used when the thread's generation matches the current trace's.
+ *
+ * @return Returns the buffer, which the trace owns, so it outlives the thread.
+ */
+Trace::Buffer* Trace::get_local()
+{
+    if (Trace::local == nullptr || Trace::local_generation != Trace::generation) {
+        std::lock_guard<std::mutex> guard(Trace::m);
+        Trace::local_generation = Trace::generation;
+        Trace::buffers.push_back(std::make_unique<Buffer>());
+        Trace::local = Trace::buffers.back().get();
+        Trace::local->tid = static_cast<uint32_t>(Trace::buffers.size());
+        Trace::local->events.reserve(1024);
+    }
+    return Trace::local;
+}
+
+/**
+ * @brief HELPER - Appends one event to the calling thread's buffer, unless it is full.
+ *
+ * @param name What the thread began or stopped doing.
+ * @param phase 'B' or 'E'.
+ */
+void Trace::record(const char* name, char phase)
+{
+    clock::duration since = clock::now() - Trace::opened;
+    int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(since).count();
+    Buffer* buffer = Trace::get_local();
+    if (buffer->events.size() < Trace::MAX_EVENTS) buffer->events.push_back({name, phase, time});
+    else buffer->dropped++;
+}